@@ -0,0 +1,190 @@
+/* Operation-size microbenchmarks for int2048, printed as JSON for plotting scaling curves and locating crossovers.
+
+   g++ -std=gnu++17 -O2 -I. bench/bench.cpp -o bench/bench && bench/bench > bench.json
+
+   Options:
+     --min-time SECONDS  time spent on each measurement, at least one run (default 0.1)
+     --max-digits N      largest operand size swept, from 10 digits up in steps of about sqrt(10) (default 1000000)
+     --ops LIST          comma-separated subset of: construct,read,print,add,sub,mul,square,div,compare
+   Add -DINT2048_SEGMENT_BITS=64 to measure the other segment layout.
+
+   Each result reports ns per operation, limbs (segments of the larger operand) processed per second, and heap
+   allocations per operation counted through the global operator new, over-aligned ones included. "balanced" operands have the same number of
+   digits (for div, a 2n-digit numerator over an n-digit denominator); "unbalanced" ones pair n digits with n / 16. */
+
+#include "int2048.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+std::size_t allocations = 0;
+/// Results end up here, so the optimizer cannot drop the measured operations.
+volatile std::size_t resultSink;
+
+} // namespace
+
+void *operator new (std::size_t size) {
+  ++allocations;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void *operator new[] (std::size_t size) {
+  return operator new(size);
+}
+// the scratch arena allocates its blocks over-aligned, through these.
+void *operator new (std::size_t size, std::align_val_t alignment) {
+  ++allocations;
+  const std::size_t align = static_cast<std::size_t>(alignment);
+  // aligned_alloc wants a multiple of the alignment.
+  if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align))) return p;
+  throw std::bad_alloc();
+}
+void *operator new[] (std::size_t size, std::align_val_t alignment) {
+  return operator new(size, alignment);
+}
+void operator delete (void *p) noexcept { std::free(p); }
+void operator delete[] (void *p) noexcept { std::free(p); }
+void operator delete (void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[] (void *p, std::size_t) noexcept { std::free(p); }
+void operator delete (void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[] (void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete (void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[] (void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+using sjtu::int2048;
+
+constexpr int DIGITS_PER_LIMB = INT2048_SEGMENT_BITS == 64 ? 19 : 9;
+
+/// Discards what is written to it, so operator<< is timed without the cost of storing the text.
+class NullBuffer : public std::streambuf {
+ protected:
+  int overflow (int c) override { return c; }
+  std::streamsize xsputn (const char *, std::streamsize count) override { return count; }
+};
+
+struct Measurement {
+  double nsPerOp;
+  double allocationsPerOp;
+  long long iterations;
+};
+
+/// Runs op once to warm up the scratch arena and caches, then repeatedly for at least minTime seconds.
+template <typename Op>
+Measurement measure (double minTime, const Op &op) {
+  using Clock = std::chrono::steady_clock;
+  op();
+  long long iterations = 0;
+  const std::size_t allocationsBefore = allocations;
+  const Clock::time_point start = Clock::now();
+  double elapsed = 0;
+  // doubling batches keep the clock reads out of the timing of fast operations.
+  for (long long batch = 1; elapsed < minTime; batch *= 2) {
+    for (long long i = 0; i < batch; ++i) op();
+    iterations += batch;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return { elapsed * 1e9 / iterations, static_cast<double>(allocations - allocationsBefore) / iterations, iterations };
+}
+
+std::string randomDigits (std::mt19937_64 &rng, int digits) {
+  std::string s(digits, '0');
+  s[0] = '1' + rng() % 9;
+  for (int i = 1; i < digits; ++i) s[i] = '0' + rng() % 10;
+  return s;
+}
+
+bool first = true;
+
+void report (const char *op, const char *shape, int digits, int maxDigits, const Measurement &m) {
+  const long long limbs = (maxDigits + DIGITS_PER_LIMB - 1) / DIGITS_PER_LIMB;
+  std::printf("%s\n    {\"op\": \"%s\", \"shape\": \"%s\", \"digits\": %d, \"limbs\": %lld, \"iterations\": %lld, "
+              "\"ns_per_op\": %.1f, \"limbs_per_second\": %.4g, \"allocations_per_op\": %.3f}",
+              first ? "" : ",", op, shape, digits, limbs, m.iterations, m.nsPerOp, limbs * 1e9 / m.nsPerOp, m.allocationsPerOp);
+  std::fflush(stdout);
+  first = false;
+}
+
+} // namespace
+
+int main (int argc, char **argv) {
+  double minTime = 0.1;
+  int maxDigits = 1000000;
+  std::string ops = "construct,read,print,add,sub,mul,square,div,compare";
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string option = argv[i];
+    if (option == "--min-time") {
+      minTime = std::atof(argv[i + 1]);
+    } else if (option == "--max-digits") {
+      maxDigits = std::atoi(argv[i + 1]);
+    } else if (option == "--ops") {
+      ops = argv[i + 1];
+    } else {
+      std::fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  const auto enabled = [&] (const char *op) {
+    const std::string list = "," + ops + ",";
+    return list.find("," + std::string(op) + ",") != std::string::npos;
+  };
+
+  std::vector<int> sizes;
+  for (int decade = 10; decade <= maxDigits; decade *= 10) {
+    sizes.push_back(decade);
+    if (decade * 3 <= maxDigits) sizes.push_back(decade * 3);
+  }
+
+  std::mt19937_64 rng(2048);
+  NullBuffer nullBuffer;
+  std::ostream nullStream(&nullBuffer);
+  std::size_t sink = 0;
+  std::printf("{\n  \"segment_bits\": %d,\n  \"min_time\": %g,\n  \"results\": [", INT2048_SEGMENT_BITS, minTime);
+  for (int n : sizes) {
+    const int small = n / 16 > 0 ? n / 16 : 1;
+    const std::string text = randomDigits(rng, n);
+    const int2048 a(text), b(randomDigits(rng, n)), c(randomDigits(rng, small)), wide(randomDigits(rng, 2 * n));
+    if (enabled("construct")) {
+      report("construct", "balanced", n, n, measure(minTime, [&] { sink += int2048(text).charsLength(); }));
+    }
+    if (enabled("read")) {
+      int2048 x;
+      report("read", "balanced", n, n, measure(minTime, [&] { x.read(text); sink += x.charsLength(); }));
+    }
+    if (enabled("print")) {
+      report("print", "balanced", n, n, measure(minTime, [&] { nullStream << a; }));
+    }
+    if (enabled("add")) {
+      report("add", "balanced", n, n, measure(minTime, [&] { sink += (a + b).charsLength(); }));
+      report("add", "unbalanced", n, n, measure(minTime, [&] { sink += (a + c).charsLength(); }));
+    }
+    if (enabled("sub")) {
+      report("sub", "balanced", n, n, measure(minTime, [&] { sink += (a - b).charsLength(); }));
+      report("sub", "unbalanced", n, n, measure(minTime, [&] { sink += (a - c).charsLength(); }));
+    }
+    if (enabled("mul")) {
+      report("mul", "balanced", n, n, measure(minTime, [&] { sink += (a * b).charsLength(); }));
+      report("mul", "unbalanced", n, n, measure(minTime, [&] { sink += (a * c).charsLength(); }));
+    }
+    if (enabled("square")) {
+      report("square", "balanced", n, n, measure(minTime, [&] { sink += sqr(a).charsLength(); }));
+    }
+    if (enabled("div")) {
+      report("div", "balanced", n, 2 * n, measure(minTime, [&] { sink += (wide / a).charsLength(); }));
+      report("div", "unbalanced", n, n, measure(minTime, [&] { sink += (a / c).charsLength(); }));
+    }
+    if (enabled("compare")) {
+      // equal but for the last digit, so the comparison reads every segment.
+      const int2048 nearA = a + 1;
+      report("compare", "balanced", n, n, measure(minTime, [&] { sink += a < nearA; }));
+      report("compare", "unbalanced", n, n, measure(minTime, [&] { sink += a < c; }));
+    }
+  }
+  std::printf("\n  ]\n}\n");
+  resultSink = sink;
+  return 0;
+}
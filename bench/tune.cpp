@@ -0,0 +1,174 @@
+/* Host auto-tuner for the algorithm crossovers of int2048, printing them as a header that int2048.hpp picks up.
+
+   g++ -std=gnu++17 -O2 -I. bench/tune.cpp -o bench/tune && bench/tune > int2048_tuned.hpp
+   g++ -std=gnu++17 -O2 -I. -DINT2048_SEGMENT_BITS=64 bench/tune.cpp -o bench/tune && bench/tune >> int2048_tuned.hpp
+
+   Options:
+     --min-time SECONDS  time spent on each measurement, the fastest of three counts (default 0.02)
+     --only LIST         comma-separated subset of: karatsuba,toom3,ntt,bz,newton,hgcd; the rest keep their current values
+
+   Each output block is guarded by the segment layout it was measured with, so the two runs above append into one
+   header. Crossovers are tuned from the bottom up: at every operand size n the operation is timed once with the
+   threshold at n, so the upper algorithm runs at the top level only, and once at n + 1, so it does not. The crossover
+   is the first size at which the upper algorithm wins twice in a row, or the end of the swept range if it never does. */
+
+#ifndef INT2048_TUNE
+#define INT2048_TUNE
+#endif
+#include "int2048.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+namespace sjtu {
+
+struct Tuner {
+  static int *threshold (const std::string &name) {
+    if (name == "karatsuba") return &int2048::KARATSUBA_THRESHOLD;
+    if (name == "toom3") return &int2048::TOOM3_THRESHOLD;
+    if (name == "ntt") return &int2048::NTT_THRESHOLD;
+    if (name == "bz") return &int2048::BZ_DIV_THRESHOLD;
+    if (name == "newton") return &int2048::NEWTON_DIV_THRESHOLD;
+    if (name == "hgcd") return &int2048::HGCD_THRESHOLD;
+    return nullptr;
+  }
+};
+
+} // namespace sjtu
+
+namespace {
+
+using sjtu::int2048;
+using Tuner = sjtu::Tuner;
+
+constexpr int DIGITS_PER_SEGMENT = INT2048_SEGMENT_BITS == 64 ? 19 : 9;
+/// Keeps the tiers above the one being tuned out of the way.
+constexpr int NEVER = 1 << 30;
+
+double minTime = 0.02;
+/// Results end up here, so the optimizer cannot drop the measured operations.
+volatile std::size_t resultSink;
+
+std::mt19937_64 rng(2048);
+
+int2048 randomSegments (int segments) {
+  std::string s(segments * DIGITS_PER_SEGMENT, '0');
+  s[0] = '1' + rng() % 9;
+  for (std::size_t i = 1; i < s.size(); ++i) s[i] = '0' + rng() % 10;
+  return int2048(s);
+}
+
+/// Seconds per call of op, the fastest of three runs of at least minTime each.
+double measure (const std::function<std::size_t ()> &op) {
+  using Clock = std::chrono::steady_clock;
+  std::size_t sink = op();
+  double best = 1e30;
+  for (int rep = 0; rep < 3; ++rep) {
+    long long iterations = 0;
+    const Clock::time_point start = Clock::now();
+    double elapsed = 0;
+    for (long long batch = 1; elapsed < minTime; batch *= 2) {
+      for (long long i = 0; i < batch; ++i) sink += op();
+      iterations += batch;
+      elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    best = std::min(best, elapsed / iterations);
+  }
+  resultSink = sink;
+  return best;
+}
+
+/* Sweeps n over [low, high] in steps of about factor and returns the crossover of *threshold.
+   makeOp builds the operation timed at size n; it runs with *threshold set before each measurement. */
+int tune (const char *name, int *threshold, int low, int high, double factor,
+          const std::function<std::function<std::size_t ()> (int)> &makeOp) {
+  int wins = 0, firstWin = high;
+  for (int n = low; n <= high; n = std::max(n + 1, static_cast<int>(n * factor))) {
+    const std::function<std::size_t ()> op = makeOp(n);
+    *threshold = n + 1;
+    const double lower = measure(op);
+    *threshold = n;
+    const double upper = measure(op);
+    std::fprintf(stderr, "%-10s n = %6d  lower %11.3f us  upper %11.3f us\n", name, n, lower * 1e6, upper * 1e6);
+    if (upper < lower) {
+      if (wins++ == 0) firstWin = n;
+      if (wins == 2) {
+        *threshold = firstWin;
+        return firstWin;
+      }
+    } else {
+      wins = 0;
+      firstWin = high;
+    }
+  }
+  *threshold = high;
+  return high;
+}
+
+std::function<std::size_t ()> mulOp (int n) {
+  const int2048 a = randomSegments(n), b = randomSegments(n);
+  return [a, b] { return (a * b).charsLength(); };
+}
+
+std::function<std::size_t ()> divOp (int n) {
+  const int2048 a = randomSegments(2 * n), b = randomSegments(n);
+  return [a, b] { return (a / b).charsLength(); };
+}
+
+std::function<std::size_t ()> gcdOp (int n) {
+  const int2048 a = randomSegments(n), b = randomSegments(n);
+  return [a, b] { return gcd(a, b).charsLength(); };
+}
+
+} // namespace
+
+int main (int argc, char **argv) {
+  std::string only = "karatsuba,toom3,ntt,bz,newton,hgcd";
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string option = argv[i];
+    if (option == "--min-time") {
+      minTime = std::atof(argv[i + 1]);
+    } else if (option == "--only") {
+      only = argv[i + 1];
+    } else {
+      std::fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  const auto enabled = [&] (const char *name) {
+    const std::string list = "," + only + ",";
+    return list.find("," + std::string(name) + ",") != std::string::npos;
+  };
+
+  int *karatsuba = Tuner::threshold("karatsuba"), *toom3 = Tuner::threshold("toom3"), *ntt = Tuner::threshold("ntt");
+  int *bz = Tuner::threshold("bz"), *newton = Tuner::threshold("newton"), *hgcd = Tuner::threshold("hgcd");
+  const int defaults[] = { *karatsuba, *toom3, *ntt, *bz, *newton, *hgcd };
+
+  // every tier is tuned with the tiers above it disabled and the ones below at their tuned values.
+  *toom3 = *ntt = NEVER;
+  if (enabled("karatsuba")) tune("karatsuba", karatsuba, 4, 128, 1.1, mulOp);
+  if (enabled("toom3")) tune("toom3", toom3, std::max(*karatsuba * 3, 24), 1024, 1.12, mulOp);
+  else *toom3 = defaults[1];
+  if (enabled("ntt")) tune("ntt", ntt, std::max(*toom3, 128), 8192, 1.15, mulOp);
+  else *ntt = defaults[2];
+  *newton = NEVER;
+  if (enabled("bz")) tune("bz", bz, 16, 1024, 1.12, divOp);
+  if (enabled("newton")) tune("newton", newton, std::max(*bz * 4, 1024), 32768, 1.25, divOp);
+  else *newton = defaults[4];
+  if (enabled("hgcd")) tune("hgcd", hgcd, 32, 16384, 1.2, gcdOp);
+
+  std::printf("/* algorithm crossovers measured by bench/tune for %d-bit segments; see int2048.hpp. */\n", INT2048_SEGMENT_BITS);
+  std::printf("#if INT2048_SEGMENT_BITS == %d\n", INT2048_SEGMENT_BITS);
+  const std::pair<const char *, int> results[] = {
+    { "KARATSUBA", *karatsuba }, { "TOOM3", *toom3 }, { "NTT", *ntt },
+    { "BZ_DIV", *bz }, { "NEWTON_DIV", *newton }, { "HGCD", *hgcd },
+  };
+  // definitions made before int2048.hpp is included, such as on the command line, still win over the tuned values.
+  for (const auto &result : results) {
+    std::printf("#ifndef INT2048_%s_THRESHOLD\n#define INT2048_%s_THRESHOLD %d\n#endif\n", result.first, result.first, result.second);
+  }
+  std::printf("#endif\n");
+  return 0;
+}
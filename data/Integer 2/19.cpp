@@ -0,0 +1,25 @@
+/*
+Time: 2026-10-16
+Test: binary limbs (int2048b)
+*/
+
+#include "int2048b.hpp"
+
+sjtu::int2048b a, b;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a >> b;
+        std::cout << a + b << '\n';
+        std::cout << a - b << '\n';
+        std::cout << a * b << '\n';
+        if (a < 0) a = 0 - a;
+        if (b < 0) b = 0 - b;
+        if (b != 0) std::cout << a / b << '\n';
+        std::cout << (a == b) << (a < b) << (a >= b) << '\n';
+    }
+}
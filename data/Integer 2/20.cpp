@@ -0,0 +1,26 @@
+/*
+Time: 2026-10-16
+Test: mul & div & mod by machine integers
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a;
+long long b;
+unsigned long long c;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a >> b >> c;
+        std::cout << a * b << ' ' << a / b << ' ' << a % b << '\n';
+        std::cout << a * c << ' ' << a / c << ' ' << a % c << '\n';
+        a *= b;
+        a /= 114514;
+        a %= c;
+        std::cout << a << '\n';
+    }
+}
@@ -0,0 +1,27 @@
+/*
+Time: 2026-10-16
+Test: divmod & mod with negative operands
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a, b;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a >> b;
+        std::cout << a / b << ' ' << a % b << '\n';
+        auto [q, r] = divmod(a, b);
+        std::cout << q << ' ' << r << '\n';
+        auto [tq, tr] = tdivmod(a, b);
+        std::cout << tq << ' ' << tr << '\n';
+        std::cout << (q * b + r == a) << ' ' << (tq * b + tr == a) << '\n';
+        a %= b;
+        a /= b;
+        std::cout << a << '\n';
+    }
+}
@@ -0,0 +1,26 @@
+/*
+Time: 2026-10-16
+Test: square & self-multiplication
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a, b;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a;
+        b = a;
+        std::cout << sqr(a) << '\n';
+        std::cout << (a * a == b * a) << ' ' << (a * b == sqr(b)) << '\n';
+        a *= a;
+        b.square();
+        std::cout << (a == b) << '\n';
+        a *= b;
+        std::cout << a << '\n';
+    }
+}
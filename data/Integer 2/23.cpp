@@ -0,0 +1,39 @@
+/*
+Time: 2026-10-16
+Test: parallel policy (mul & div)
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a, b, p, q;
+std::string s1, s2;
+
+void run()
+{
+    p = a * b;
+    q = p / b;
+    std::cout << (p % 1000000007) << ' ' << (q == a) << ' ' << (sqr(b) == b * b) << '\n';
+}
+
+int main()
+{
+    for (int j = 1; j <= 200000; j++)
+        s1 += (1ll * j * 19260817) % 998244353 % 10 + '0';
+    for (int j = 1; j <= 150000; j++)
+        s2 += (1ll * j * 998244353) % 19260817 % 10 + '0';
+    a = s1; b = s2;
+    b = b + 1;
+
+    run();
+    sjtu::int2048::ParallelPolicy policy;
+    policy.threads = 4;
+    sjtu::int2048::setParallelPolicy(policy);
+    run();
+    int batches = 0;
+    sjtu::int2048::setParallelPolicy({ 2, [&batches](const std::function<void ()> *tasks, int count) {
+        ++batches;
+        for (int i = count - 1; i >= 0; i--) tasks[i]();
+    } });
+    run();
+    std::cout << (batches > 0) << '\n';
+}
@@ -0,0 +1,21 @@
+/*
+Time: 2026-10-16
+Test: prepared multiplier
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a, b;
+
+int main()
+{
+    int T;
+    std::cin >> a >> T;
+    sjtu::int2048::PreparedMultiplier factor(a);
+    while (T--)
+    {
+        std::cin >> b;
+        sjtu::int2048 c = factor.apply(b);
+        std::cout << (c == a * b) << ' ' << c % 1000000007 << '\n';
+    }
+}
@@ -0,0 +1,23 @@
+/*
+Time: 2026-10-16
+Test: pow & powmod
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a, e, m;
+unsigned n;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a >> n >> e >> m;
+        std::cout << pow(a, n) << '\n';
+        std::cout << powmod(a, e, m) << '\n';
+        sjtu::int2048::Modulus modulus(m);
+        std::cout << modulus.mul(modulus.reduce(a), modulus.reduce(e)) << ' ' << modulus.pow(a, n) << '\n';
+    }
+}
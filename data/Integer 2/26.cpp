@@ -0,0 +1,26 @@
+/*
+Time: 2026-10-16
+Test: isqrt & iroot
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a;
+unsigned k;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a >> k;
+        if (a >= 0)
+        {
+            auto [s, r] = sqrtrem(a);
+            std::cout << isqrt(a) << ' ' << s << ' ' << r << '\n';
+        }
+        auto [root, remainder] = rootrem(a, k);
+        std::cout << iroot(a, k) << ' ' << root << ' ' << remainder << '\n';
+    }
+}
@@ -0,0 +1,21 @@
+/*
+Time: 2026-10-16
+Test: gcd, lcm & gcdext
+*/
+
+#include "int2048.hpp"
+
+sjtu::int2048 a, b;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        std::cin >> a >> b;
+        auto [g, s, t] = gcdext(a, b);
+        std::cout << gcd(a, b) << ' ' << lcm(a, b) << '\n';
+        std::cout << g << ' ' << s << ' ' << t << '\n';
+    }
+}
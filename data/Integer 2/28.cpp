@@ -0,0 +1,38 @@
+/*
+Time: 2026-10-16
+Test: product, factorial & binomial
+*/
+
+#include "int2048.hpp"
+#include <vector>
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    while (T--)
+    {
+        char op;
+        std::cin >> op;
+        if (op == 'f')
+        {
+            unsigned n;
+            std::cin >> n;
+            std::cout << sjtu::factorial(n) << '\n';
+        }
+        else if (op == 'b')
+        {
+            unsigned n, k;
+            std::cin >> n >> k;
+            std::cout << sjtu::binomial(n, k) << '\n';
+        }
+        else
+        {
+            int count;
+            std::cin >> count;
+            std::vector<sjtu::int2048> factors(count);
+            for (auto &factor : factors) std::cin >> factor;
+            std::cout << sjtu::product(factors.begin(), factors.end()) << '\n';
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+Time: 2026-10-16
+Test: instrumentation counters
+*/
+
+#ifndef INT2048_INSTRUMENT
+#define INT2048_INSTRUMENT
+#endif
+// the checks below expect the default crossovers, not those of a tuned header.
+#define INT2048_NO_TUNED_HEADER
+#include "int2048.hpp"
+
+using sjtu::int2048;
+
+int2048 digits(int n, long long seed)
+{
+    std::string s;
+    for (int j = 1; j <= n; j++)
+        s += (1ll * j * seed) % 998244353 % 10 + '0';
+    s[0] = '7';
+    return s;
+}
+
+int main()
+{
+    int2048 a = digits(1000, 19260817), b = digits(1000, 998244353);
+    int2048 big = digits(200000, 19260817), wide = digits(40000, 1000000007), narrow = digits(20000, 19260817);
+
+    int2048::resetCounters();
+    int2048::Counters c = int2048::counters();
+    std::cout << (c.addSegments == 0 && c.allocations == 0 && c.mulSchoolbook == 0 && c.maxDepth == 0) << '\n';
+
+    int2048 p = a * b;
+    c = int2048::counters();
+    std::cout << (c.mulKaratsuba > 0) << ' ' << (c.mulSchoolbook > 0) << ' ' << (c.segmentProducts > 0) << ' '
+              << (c.mulNtt == 0) << ' ' << (c.maxDepth >= 2) << ' ' << (c.addSegments > 0) << '\n';
+
+    int2048::resetCounters();
+    p = big * (big + 1);
+    std::cout << (int2048::counters().mulNtt > 0) << ' ' << (int2048::counters().squarings == 0) << '\n';
+    int2048::resetCounters();
+    p = sqr(big);
+    std::cout << (int2048::counters().squarings > 0) << '\n';
+
+    int2048::resetCounters();
+    p = (a * b + 12345) / b;
+    c = int2048::counters();
+    std::cout << (p == a) << ' ' << (c.divSchoolbook > 0) << ' ' << (c.divBurnikelZiegler == 0) << '\n';
+    int2048::resetCounters();
+    p = wide * narrow / narrow;
+    c = int2048::counters();
+    std::cout << (p == wide) << ' ' << (c.divBurnikelZiegler > 0) << ' ' << (c.divNewton == 0) << '\n';
+
+    int2048::resetCounters();
+    int2048 copy = big;
+    int2048 moved = std::move(copy);
+    c = int2048::counters();
+    std::cout << (c.copiedBytes >= 200000 / 19 * 8) << ' ' << (c.copiedBytes < 200000) << ' ' << (c.allocations == 1) << '\n';
+
+    int2048::resetCounters();
+    p = gcd(a * 6, b * 4);
+    c = int2048::counters();
+    std::cout << (p % 2 == 0) << ' ' << (c.gcdLehmerSteps > 0) << ' ' << (c.gcdHalfGcd == 0) << '\n';
+}
@@ -0,0 +1,48 @@
+/*
+Time: 2026-10-16
+Test: batch evaluation
+*/
+
+#include "int2048.hpp"
+#include <vector>
+
+using sjtu::int2048;
+
+int main()
+{
+    int T;
+    std::cin >> T;
+    std::vector<int2048> a(T), b(T);
+    for (int i = 0; i < T; i++)
+        std::cin >> a[i] >> b[i];
+
+    int2048::ParallelPolicy policy;
+    policy.threads = 4;
+    int2048::setParallelPolicy(policy);
+
+    const int2048::BatchOp ops[] = {int2048::BatchOp::ADD, int2048::BatchOp::MINUS, int2048::BatchOp::MUL,
+                                    int2048::BatchOp::DIV, int2048::BatchOp::MOD};
+    std::vector<std::vector<int2048>> results(5, std::vector<int2048>(T));
+    for (int k = 0; k < 5; k++)
+        evaluate(ops[k], a.data(), b.data(), results[k].data(), T);
+    for (int i = 0; i < T; i++)
+        for (int k = 0; k < 5; k++)
+            std::cout << results[k][i] << '\n';
+
+    // results in place of either operand.
+    std::vector<int2048> c = a;
+    evaluate(int2048::BatchOp::ADD, c.data(), b.data(), c.data(), T);
+    evaluate(int2048::BatchOp::MINUS, c.data(), b.data(), c.data(), T);
+    std::vector<int2048> d = b;
+    evaluate(int2048::BatchOp::MUL, a.data(), d.data(), d.data(), T);
+    bool same = c == a && d == results[2];
+    evaluate(int2048::BatchOp::MINUS, c.data(), c.data(), c.data(), T);
+    for (int i = 0; i < T; i++)
+        same = same && c[i] == 0;
+
+    // a serial policy gives the same results.
+    int2048::setParallelPolicy(int2048::ParallelPolicy());
+    std::vector<int2048> serial(T);
+    evaluate(int2048::BatchOp::MOD, a.data(), b.data(), serial.data(), T);
+    std::cout << (same && serial == results[4]) << '\n';
+}
@@ -0,0 +1,39 @@
+/*
+Time: 2026-10-16
+Test: Burnikel–Ziegler normalization of a divisor led by 1, 99...9
+*/
+
+#ifndef INT2048_INSTRUMENT
+#define INT2048_INSTRUMENT
+#endif
+#define INT2048_NO_TUNED_HEADER
+#include "int2048.hpp"
+
+using sjtu::int2048;
+
+std::string digits(std::size_t n, long long seed, std::string s = "")
+{
+    for (int j = 1; s.size() < n; j++)
+        s += (1ll * j * seed) % 998244353 % 10 + '0';
+    if (s[0] == '0') s[0] = '7';
+    return s;
+}
+
+int main()
+{
+    // the leading segment is 1 and the next one is all nines, in either layout; both stay below the Newton crossover.
+    const std::size_t segLength = INT2048_SEGMENT_BITS == 64 ? 19 : 9;
+    const int2048 adversarial = digits(6000 * segLength + 1, 19260817, "1" + std::string(segLength, '9'));
+    const int2048 random = digits(6000 * segLength, 998244353);
+    const int2048 numerator = digits(12000 * segLength, 1000000007);
+
+    for (const int2048 *denominator : {&adversarial, &random})
+    {
+        int2048::resetCounters();
+        int2048 quotient = numerator / *denominator, remainder = numerator % *denominator;
+        int2048::Counters c = int2048::counters();
+        std::cout << (quotient * *denominator + remainder == numerator) << ' ' << (remainder < *denominator) << ' '
+                  << (c.divBurnikelZiegler == 2) << ' ' << (c.divBlocks > 0) << ' '
+                  << (c.divCorrections <= 2 * c.divBlocks) << '\n';
+    }
+}
@@ -0,0 +1,50 @@
+/*
+Time: 2026-10-16
+Test: memory resources & noexcept move assignment
+*/
+
+#include "int2048.hpp"
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+using sjtu::int2048;
+
+static_assert(std::is_nothrow_move_constructible<int2048>::value, "");
+static_assert(std::is_nothrow_move_assignable<int2048>::value, "");
+
+int main()
+{
+    std::pmr::monotonic_buffer_resource arena;
+    const std::string digits(2000, '7');
+
+    // compound assignments keep the resource of their left operand.
+    int2048 x(digits, &arena);
+    int2048 y(digits.substr(0, 1000));
+    x = int2048(digits, &arena);
+    x /= y;
+    x %= int2048(12345);
+    x += int2048(digits);
+    x *= y;
+    std::cout << (x.resource() == &arena) << '\n';
+
+    // move assignment takes the storage of its right operand, resource included.
+    int2048 z(1, &arena);
+    z = int2048(digits);
+    int2048 w;
+    w = std::move(x);
+    std::cout << (z.resource() == nullptr) << ' ' << (w.resource() == &arena) << ' '
+              << (w == (int2048(digits) / y % 12345 + int2048(digits)) * y) << '\n';
+
+    // so does copy assignment and evaluate, even when the result aliases the right operand.
+    std::vector<int2048> a(8, int2048(digits)), b;
+    for (int i = 0; i < 8; i++)
+        b.emplace_back(int2048(i + 1) * y, &arena);
+    int2048 copy(0, &arena);
+    copy = a[0];
+    evaluate(int2048::BatchOp::DIV, a.data(), b.data(), b.data(), b.size());
+    bool kept = copy.resource() == &arena;
+    for (int i = 0; i < 8; i++)
+        kept = kept && b[i].resource() == &arena && b[i] == int2048(digits) / ((i + 1) * y);
+    std::cout << kept << '\n';
+}
@@ -5,11 +5,83 @@
 #include <cstring>
 #include <cstdio>
 #include <vector>
+#include <algorithm>
 #include <complex>
+#include <cmath>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <system_error>
+#include <new>
+#include <memory_resource>
+#include <type_traits>
+#include <functional>
+#include <atomic>
+#include <thread>
 
 // Permitted by @Sakits
 #include <cstdint>
 
+/* segment layout: 32 packs base 10 ** 9 segments into std::uint32_t,
+   64 stores base 10 ** 19 segments in std::uint64_t with 128-bit intermediates, halving the segment count. */
+#ifndef INT2048_SEGMENT_BITS
+#define INT2048_SEGMENT_BITS 32
+#endif
+#if INT2048_SEGMENT_BITS != 32 && INT2048_SEGMENT_BITS != 64
+#error "INT2048_SEGMENT_BITS must be 32 or 64"
+#endif
+
+/* algorithm crossovers, in segments; the int2048 members of the same names describe what each one switches.
+   int2048_tuned.hpp next to this header, as generated on the build host by bench/tune, takes precedence over the defaults
+   below, and definitions on the command line over both. INT2048_NO_TUNED_HEADER keeps the defaults even when the tuned
+   header is present, and INT2048_TUNE turns the crossovers into variables for the tuner. */
+#if !defined(INT2048_NO_TUNED_HEADER) && defined(__has_include)
+#if __has_include("int2048_tuned.hpp")
+#include "int2048_tuned.hpp"
+#endif
+#endif
+#ifndef INT2048_KARATSUBA_THRESHOLD
+#define INT2048_KARATSUBA_THRESHOLD (INT2048_SEGMENT_BITS == 64 ? 16 : 32)
+#endif
+#ifndef INT2048_TOOM3_THRESHOLD
+#define INT2048_TOOM3_THRESHOLD (INT2048_SEGMENT_BITS == 64 ? 192 : 256)
+#endif
+#ifndef INT2048_NTT_THRESHOLD
+#define INT2048_NTT_THRESHOLD (INT2048_SEGMENT_BITS == 64 ? 2048 : 768)
+#endif
+#ifndef INT2048_BZ_DIV_THRESHOLD
+#define INT2048_BZ_DIV_THRESHOLD (INT2048_SEGMENT_BITS == 64 ? 64 : 128)
+#endif
+#ifndef INT2048_NEWTON_DIV_THRESHOLD
+#define INT2048_NEWTON_DIV_THRESHOLD (INT2048_SEGMENT_BITS == 64 ? 8192 : 16384)
+#endif
+#ifndef INT2048_HGCD_THRESHOLD
+#define INT2048_HGCD_THRESHOLD (INT2048_SEGMENT_BITS == 64 ? 256 : 512)
+#endif
+#ifdef INT2048_TUNE
+#define INT2048_TUNABLE_ static inline int
+#else
+#define INT2048_TUNABLE_ static constexpr int
+#endif
+
+/* add and subtract kernels for base 10 ** 9 segments use AVX2 or AVX-512 when the CPU running the program has them.
+   The choice is made at run time, so one binary runs everywhere; define INT2048_NO_SIMD to keep only the scalar kernels. */
+#if !defined(INT2048_NO_SIMD) && INT2048_SEGMENT_BITS == 32 && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define INT2048_SIMD_
+#include <immintrin.h>
+#endif
+
+/* INT2048_INSTRUMENT keeps per-thread counters of the work int2048 does and the algorithms it picks, read through
+   int2048::counters(). Without it the counting statements expand to nothing. */
+#ifdef INT2048_INSTRUMENT
+#define INT2048_COUNT_(counter, amount) (countersLocal_().counter += (amount))
+#define INT2048_DEPTH_() const DepthScope_ depthScope_
+#else
+#define INT2048_COUNT_(counter, amount) ((void)0)
+#define INT2048_DEPTH_() ((void)0)
+#endif
+
 #ifdef ONLINE_JUDGE
 // using `sizeof` here to suppress annoying warnings on unused variables, etc.
 #define assert(...) sizeof(__VA_ARGS__)
@@ -20,99 +92,346 @@
 namespace sjtu {
 class int2048 {
  private:
-  using SegType = std::uint_fast32_t;
-  static constexpr SegType EXP10[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+#if INT2048_SEGMENT_BITS == 64
+  using SegType = std::uint64_t;
+  static constexpr int SEG_LENGTH = 19;
+  /// Holds a product of two segments plus a segment, signed for borrows.
+  __extension__ using TmpType = __int128;
+#else
+  using SegType = std::uint32_t;
   static constexpr int SEG_LENGTH = 9;
+  using TmpType = std::int64_t;
+#endif
+  __extension__ using WideType = unsigned __int128;
+  static constexpr std::uint64_t EXP10[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+  };
   static constexpr SegType SEG_MAX = EXP10[SEG_LENGTH];
-  using TmpType = std::int_fast64_t;
+  /* multiplication crossovers, in segments of the shorter operand:
+     schoolbook below KARATSUBA_THRESHOLD, then Karatsuba, Toom-3, and the NTT from NTT_THRESHOLD on.
+     with 64-bit segments the quadratic kernels reduce through 128-bit division and lose sooner, while the NTT pays for regrouping. */
+  INT2048_TUNABLE_ KARATSUBA_THRESHOLD = INT2048_KARATSUBA_THRESHOLD;
+  INT2048_TUNABLE_ TOOM3_THRESHOLD = INT2048_TOOM3_THRESHOLD;
+  INT2048_TUNABLE_ NTT_THRESHOLD = INT2048_NTT_THRESHOLD;
+  /* division crossovers: long division unless both the divisor and the quotient have at least BZ_DIV_THRESHOLD segments.
+     Above that, Burnikel–Ziegler recursion, whose blocks switch to a Newton reciprocal from NEWTON_DIV_THRESHOLD segments on. */
+  INT2048_TUNABLE_ BZ_DIV_THRESHOLD = INT2048_BZ_DIV_THRESHOLD;
+  INT2048_TUNABLE_ NEWTON_DIV_THRESHOLD = INT2048_NEWTON_DIV_THRESHOLD;
+  /// gcd and gcdext reduce by half-GCD recursion while the smaller operand has at least HGCD_THRESHOLD segments, and by Lehmer steps below.
+  INT2048_TUNABLE_ HGCD_THRESHOLD = INT2048_HGCD_THRESHOLD;
+#ifdef INT2048_TUNE
+  /// bench/tune moves the crossovers above while it measures.
+  friend struct Tuner;
+#endif
+  /// Reciprocals at most this precise are computed by long division.
+  static constexpr int NEWTON_BASE_PRECISION = 32;
+  /// Segments kept inside the object itself; most numbers in practice fit in a few.
+  static constexpr int INLINE_SEGMENTS = 4;
+
+  /** A vector of trivially copyable T that stores up to N elements inline and spills to the heap when it grows past that.
+      Heap buffers come from resource if one is given, and from new[] otherwise; a moved buffer takes its resource along. */
+  template <typename T, int N>
+  class SmallVector_ {
+   public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<T *>;
+    using const_reverse_iterator = std::reverse_iterator<const T *>;
+
+    SmallVector_ () noexcept {}
+    explicit SmallVector_ (std::pmr::memory_resource *resource) noexcept : resource_(resource) {}
+    SmallVector_ (std::size_t count, const T &value) {
+      assign(count, value);
+    }
+    SmallVector_ (const SmallVector_ &that) {
+      assign(that.begin(), that.end());
+    }
+    SmallVector_ (SmallVector_ &&that) noexcept {
+      steal_(that);
+    }
+    ~SmallVector_ () {
+      if (!isInline_()) deallocate_(data_, capacity_);
+    }
+    SmallVector_ &operator= (const SmallVector_ &that) {
+      if (this != &that) assign(that.begin(), that.end());
+      return *this;
+    }
+    SmallVector_ &operator= (SmallVector_ &&that) noexcept {
+      if (this == &that) return *this;
+      if (!isInline_()) deallocate_(data_, capacity_);
+      steal_(that);
+      return *this;
+    }
+    void swap (SmallVector_ &that) noexcept {
+      if (!isInline_() && !that.isInline_()) {
+        std::swap(data_, that.data_);
+        std::swap(size_, that.size_);
+        std::swap(capacity_, that.capacity_);
+        std::swap(resource_, that.resource_);
+        return;
+      }
+      SmallVector_ tmp(std::move(that));
+      that = std::move(*this);
+      *this = std::move(tmp);
+    }
+
+    std::pmr::memory_resource *resource () const { return resource_; }
+    std::size_t size () const { return size_; }
+    bool empty () const { return size_ == 0; }
+    T *data () { return data_; }
+    const T *data () const { return data_; }
+    T &operator[] (std::size_t i) { return data_[i]; }
+    const T &operator[] (std::size_t i) const { return data_[i]; }
+    T &back () { return data_[size_ - 1]; }
+    const T &back () const { return data_[size_ - 1]; }
+    iterator begin () { return data_; }
+    iterator end () { return data_ + size_; }
+    const_iterator begin () const { return data_; }
+    const_iterator end () const { return data_ + size_; }
+    reverse_iterator rbegin () { return reverse_iterator(end()); }
+    reverse_iterator rend () { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin () const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend () const { return const_reverse_iterator(begin()); }
+
+    void reserve (std::size_t capacity) {
+      if (capacity <= capacity_) return;
+      T *data = allocate_(capacity);
+      if (size_ > 0) std::memcpy(data, data_, size_ * sizeof(T));
+      if (!isInline_()) deallocate_(data_, capacity_);
+      data_ = data;
+      capacity_ = capacity;
+    }
+    void clear () { size_ = 0; }
+    void push_back (const T &value) {
+      if (size_ == capacity_) reserve(capacity_ * 2);
+      data_[size_++] = value;
+    }
+    void pop_back () { --size_; }
+    void resize (std::size_t count, const T &value = T()) {
+      reserve(count);
+      for (std::size_t i = size_; i < count; ++i) data_[i] = value;
+      size_ = count;
+    }
+    void assign (std::size_t count, const T &value) {
+      size_ = 0;
+      resize(count, value);
+    }
+    void assign (const T *first, const T *last) {
+      size_ = 0;
+      reserve(last - first);
+      if (last != first) std::memcpy(data_, first, (last - first) * sizeof(T));
+      size_ = last - first;
+    }
+    /// Inserts count copies of value before pos.
+    iterator insert (const_iterator pos, std::size_t count, const T &value) {
+      const std::size_t offset = pos - data_;
+      if (size_ + count > capacity_) reserve(size_ + count > capacity_ * 2 ? size_ + count : capacity_ * 2);
+      std::memmove(data_ + offset + count, data_ + offset, (size_ - offset) * sizeof(T));
+      for (std::size_t i = 0; i < count; ++i) data_[offset + i] = value;
+      size_ += count;
+      return data_ + offset;
+    }
+    iterator erase (const_iterator first, const_iterator last) {
+      const std::size_t offset = first - data_;
+      const std::size_t count = last - first;
+      std::memmove(data_ + offset, data_ + offset + count, (size_ - offset - count) * sizeof(T));
+      size_ -= count;
+      return data_ + offset;
+    }
+
+   private:
+    T inline_[N];
+    T *data_ = inline_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = N;
+    /// nullptr for new[] and delete[].
+    std::pmr::memory_resource *resource_ = nullptr;
+
+    bool isInline_ () const { return data_ == inline_; }
+    T *allocate_ (std::size_t count) {
+      INT2048_COUNT_(allocations, 1);
+      INT2048_COUNT_(allocatedBytes, count * sizeof(T));
+      return resource_ ? static_cast<T *>(resource_->allocate(count * sizeof(T), alignof(T))) : new T[count];
+    }
+    void deallocate_ (T *data, std::size_t count) {
+      if (resource_) {
+        resource_->deallocate(data, count * sizeof(T), alignof(T));
+      } else {
+        delete[] data;
+      }
+    }
+    /// Takes over the contents of that, leaving it empty and inline. Requires this to own no heap buffer.
+    void steal_ (SmallVector_ &that) noexcept {
+      size_ = that.size_;
+      resource_ = that.resource_;
+      if (that.isInline_()) {
+        data_ = inline_;
+        capacity_ = N;
+        std::memcpy(inline_, that.inline_, size_ * sizeof(T));
+      } else {
+        data_ = that.data_;
+        capacity_ = that.capacity_;
+      }
+      that.data_ = that.inline_;
+      that.size_ = 0;
+      that.capacity_ = N;
+    }
+  };
+  using SegmentVector_ = SmallVector_<SegType, INLINE_SEGMENTS>;
+
   /// Little-endian.
-  std::vector<SegType> segments_;
+  SegmentVector_ segments_;
   /// True if negative.
   bool signbit_ = false;
 
-  static SegType ninesComplement_ (const SegType &number) { return SEG_MAX - number - 1; }
+  /** Per-thread bump allocator for the temporaries of the multiplication and division kernels.
+      Buffers are taken and handed back in stack order through ScratchFrame_. Once the outermost frame closes,
+      the blocks are merged into one, so repeated operations of similar size stop touching the heap. */
+  class ScratchArena_ {
+   public:
+    struct Mark {
+      std::size_t block;
+      std::size_t offset;
+    };
+    static ScratchArena_ &local () {
+      static thread_local ScratchArena_ arena;
+      return arena;
+    }
+    ~ScratchArena_ () {
+      freeBlocks_();
+    }
+    Mark mark () const { return { current_, offset_ }; }
+    void release (const Mark &mark) {
+      current_ = mark.block;
+      offset_ = mark.offset;
+      if (current_ == 0 && offset_ == 0 && blocks_.size() > 1) {
+        const std::size_t total = total_;
+        freeBlocks_();
+        if (total <= RETAINED_BYTES) addBlock_(total);
+      }
+    }
+    void *allocate (std::size_t bytes) {
+      bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+      for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+        if (offset_ + bytes <= blocks_[current_].size) {
+          void *data = blocks_[current_].data + offset_;
+          offset_ += bytes;
+          return data;
+        }
+      }
+      // grow geometrically, so a thread needs few blocks before the first merge.
+      addBlock_(std::max(bytes, std::max(MIN_BLOCK_BYTES, total_)));
+      current_ = blocks_.size() - 1;
+      offset_ = bytes;
+      return blocks_.back().data;
+    }
+
+   private:
+    struct Block {
+      char *data;
+      std::size_t size;
+    };
+    static constexpr std::size_t ALIGNMENT = 64;
+    static constexpr std::size_t MIN_BLOCK_BYTES = 1 << 16;
+    /// Larger merged blocks are given back to the heap instead of being kept for the thread.
+    static constexpr std::size_t RETAINED_BYTES = 1 << 26;
+    std::vector<Block> blocks_;
+    std::size_t current_ = 0;
+    std::size_t offset_ = 0;
+    std::size_t total_ = 0;
+
+    void addBlock_ (std::size_t size) {
+      INT2048_COUNT_(allocations, 1);
+      INT2048_COUNT_(allocatedBytes, size);
+      blocks_.push_back({ static_cast<char *>(::operator new(size, std::align_val_t(ALIGNMENT))), size });
+      total_ += size;
+    }
+    void freeBlocks_ () {
+      for (const auto &block : blocks_) ::operator delete(block.data, std::align_val_t(ALIGNMENT));
+      blocks_.clear();
+      current_ = offset_ = total_ = 0;
+    }
+  };
+  /// Takes buffers of trivially copyable types from the scratch arena of the thread, and hands them all back when it goes out of scope.
+  class ScratchFrame_ {
+   public:
+    ScratchFrame_ () : arena_(ScratchArena_::local()), mark_(arena_.mark()) {}
+    ScratchFrame_ (const ScratchFrame_ &) = delete;
+    ScratchFrame_ &operator= (const ScratchFrame_ &) = delete;
+    ~ScratchFrame_ () {
+      arena_.release(mark_);
+    }
+    /// Uninitialized buffer of count Ts.
+    template <typename T>
+    T *take (std::size_t count) {
+      return static_cast<T *>(arena_.allocate(count * sizeof(T)));
+    }
+    template <typename T>
+    T *takeZeroed (std::size_t count) {
+      T *data = take<T>(count);
+      std::memset(data, 0, count * sizeof(T));
+      return data;
+    }
+
+   private:
+    ScratchArena_ &arena_;
+    const ScratchArena_::Mark mark_;
+  };
 
   /// Strip leading zeroes.
   void normalize_ () {
-    while (segments_.back() == 0) segments_.pop_back();
+    while (segments_.size() > 1 && segments_.back() == 0) segments_.pop_back();
   }
   /// Adds values of this and that in place, disregarding sign bit.
   int2048 &addValue_ (const int2048 &that) {
-    const int szThis = segments_.size();
     const int szThat = that.segments_.size();
-    const int szMax = szThat > szThis ? szThat : szThis;
-    TmpType carry = 0;
-    for (int i = 0; i < szMax; ++i) {
-      const TmpType segThis = i < szThis ? segments_[i] : 0;
-      const TmpType segThat = i < szThat ? that.segments_[i] : 0;
-      const TmpType sum = segThis + segThat + carry;
-      const SegType sumOut = sum % SEG_MAX;
-      carry = sum / SEG_MAX;
-      if (i < szThis) {
-        segments_[i] = sumOut;
-      } else {
-        segments_.push_back(sumOut);
-      }
-    }
-    if (carry != 0) segments_.push_back(carry);
+    if (static_cast<int>(segments_.size()) < szThat) segments_.resize(szThat);
+    if (addSegments_(segments_.data(), segments_.size(), that.segments_.data(), szThat) != 0) segments_.push_back(1);
     return *this;
   }
-  /// Gets the segment at index with optional left shift of SEG_MAX with bound checks.
-  const SegType seg_ (const int &i, const bool &lshift = false) const {
-    if (lshift) {
-      if (i == 0) return 0;
-      if (i - 1 >= segments_.size()) return 0;
-      return segments_[i - 1];
+  /// Subtracts that from this in place, disregarding sign bit; the sign flips when abs(that) > abs(this).
+  int2048 &subValue_ (const int2048 &that) {
+    int szThis = segments_.size();
+    int szThat = that.segments_.size();
+    if (szThis == szThat) {
+      // equal leading segments cancel out, only the part below the highest difference is subtracted.
+      while (szThis > 0 && segments_[szThis - 1] == that.segments_[szThis - 1]) --szThis;
+      if (szThis == 0) return resetTo_(0);
+      segments_.resize(szThis);
+      szThat = szThis;
     }
-    if (i >= segments_.size()) return 0;
-    return segments_[i];
-  }
-  /// Subtracts that from this in place, with optional left shift of that by SEG_MAX, disregarding sign bit.
-  int2048 &subValue_ (const int2048 &that, bool lshift = false) {
-    const int szThis = segments_.size();
-    const int szThat = that.segments_.size() + (lshift ? 1 : 0);
-    const int szMax = szThat > szThis ? szThat : szThis;
-    TmpType borrow = 0;
-    for (int i = 0; i < szMax; ++i) {
-      const TmpType segThis = i < szThis ? segments_[i] : 0;
-      const TmpType segThat = i < szThat ? that.seg_(i, lshift) : 0;
-      TmpType difference = segThis - segThat - borrow;
-      if (difference < 0) {
-        borrow = 1;
-        difference += SEG_MAX;
-      } else {
-        borrow = 0;
-      }
-      if (i < szThis) {
-        segments_[i] = difference;
-      } else {
-        segments_.push_back(difference);
-      }
-    }
-    if (borrow) {
-      /* this happens when abs(that) > abs(this).
-           abs(a - b) = b - a
-         = -(SEG_MAX ** size + a - b) + SEG_MAX ** size
-         = (SEG_MAX ** size - 1) - (SEG_MAX ** size + a - b) + 1.
-         SEG_MAX ** size + a - b is what we currently have in this.
-         SEG_MAX ** size - 1 is a series of 9s, so ((SEG_MAX ** size - 1) - this) is the nine's complement of this.
-         using nine's complement here because it never borrows.
-         we need to add one to the complement to get the result. */
+    if (szThis > szThat || (szThis == szThat && segments_[szThis - 1] > that.segments_[szThis - 1])) {
+      subSegments_(segments_.data(), szThis, that.segments_.data(), szThat);
+    } else {
+      // abs(that) > abs(this), so take that - this; it never borrows past the top segment.
+      segments_.resize(szThat);
+      subSegmentsKernel_(segments_.data(), that.segments_.data(), segments_.data(), szThat, 0);
       signbit_ = !signbit_;
-      for (auto &seg : segments_) {
-        seg = ninesComplement_(seg);
-      }
-      for (auto &seg : segments_) {
-        if (seg < SEG_MAX - 1) {
-          ++seg;
-          break;
-        }
-        seg = 0;
-      }
     }
     normalize_();
     return *this;
   }
+  /// Sets this to number.
+  void setValue_ (long long number) {
+    /* do not use `-number` here, because negating LLONG_MIN is undefined behavior.
+       See: https://github.com/python/cpython/blob/4c792f39e688b11c7c19e411ed4f76a7baa44638/Objects/longobject.c#L191-L192
+       See: https://acm.sjtu.app/t/145 */
+    setValue_(number > 0 ? number : 0ULL - number, number < 0);
+  }
+  /// Sets this to magnitude, negated if negative.
+  void setValue_ (std::uint64_t magnitude, bool negative) {
+    reset_();
+    signbit_ = negative && magnitude != 0;
+    std::uint64_t current = magnitude;
+    while (current > 0) {
+      segments_.push_back(current % SEG_MAX);
+      current /= SEG_MAX;
+    }
+    if (segments_.size() == 0) segments_.push_back(0);
+  }
   /// Resets the sign bit and the segments to their initial states.
   void reset_ () {
     signbit_ = false;
@@ -130,61 +449,847 @@ class int2048 {
     return segments_.size() == 1 && segments_[0] == static_cast<SegType>(0);
   }
 
- public:
-  int2048 () {
-    segments_.push_back(0);
+  /// Multiplies a (of size na) by b (of size nb) into out (of size na + nb, zero-filled), schoolbook style.
+  static void mulSchoolbook_ (const SegType *a, int na, const SegType *b, int nb, SegType *out) {
+    INT2048_COUNT_(segmentProducts, static_cast<std::uint64_t>(na) * nb);
+    // https://treskal.com/s/masters-thesis.pdf, Algorithm 2.3. Retrieved 2021/11/12.
+    for (int i = 0; i < na; ++i) {
+      TmpType q = 0;
+      for (int j = 0; j < nb; ++j) {
+        const TmpType tmp = static_cast<TmpType>(out[i + j]) + q + static_cast<TmpType>(a[i]) * static_cast<TmpType>(b[j]);
+        out[i + j] = tmp % SEG_MAX;
+        q = tmp / SEG_MAX;
+      }
+      out[i + nb] = q;
+    }
   }
-  int2048 (long long number) : signbit_(number < 0) {
-    /* do not use `-number` here, because negating LLONG_MIN is undefined behavior.
-       See: https://github.com/python/cpython/blob/4c792f39e688b11c7c19e411ed4f76a7baa44638/Objects/longobject.c#L191-L192
-       See: https://acm.sjtu.app/t/145 */
-    unsigned long long current = number > 0 ? number : 0ULL - number;
-    while (current > 0) {
-      segments_.push_back(current % SEG_MAX);
-      current /= SEG_MAX;
+  /// Squares a (of size n) into out (of size 2 n, zero-filled), computing each cross product once.
+  static void sqrSchoolbook_ (const SegType *a, int n, SegType *out) {
+    INT2048_COUNT_(segmentProducts, static_cast<std::uint64_t>(n) * (n + 1) / 2);
+    // a ** 2 = 2 * sum(a[i] a[j] for i < j) + sum(a[i] ** 2): the cross products fill the triangle above the diagonal.
+    for (int i = 0; i < n; ++i) {
+      TmpType q = 0;
+      for (int j = i + 1; j < n; ++j) {
+        const TmpType tmp = static_cast<TmpType>(out[i + j]) + q + static_cast<TmpType>(a[i]) * static_cast<TmpType>(a[j]);
+        out[i + j] = tmp % SEG_MAX;
+        q = tmp / SEG_MAX;
+      }
+      out[i + n] = q;
     }
-    if (segments_.size() == 0) segments_.push_back(0);
+    addSegmentsKernel_(out, out, out, 2 * n, 0);
+    TmpType carry = 0;
+    for (int i = 0; i < n; ++i) {
+      const TmpType low = static_cast<TmpType>(out[2 * i]) + static_cast<TmpType>(a[i]) * static_cast<TmpType>(a[i]) + carry;
+      out[2 * i] = low % SEG_MAX;
+      const TmpType high = static_cast<TmpType>(out[2 * i + 1]) + low / SEG_MAX;
+      out[2 * i + 1] = high % SEG_MAX;
+      carry = high / SEG_MAX;
+    }
+    assert(carry == 0);
   }
-  int2048 (const std::string &string) {
-    read(string);
+
+  /// Sets r to x + y + carry over n segments, returns the carry out. r may alias x or y.
+  static SegType addSegmentsScalar_ (SegType *r, const SegType *x, const SegType *y, int n, SegType carry) {
+    for (int i = 0; i < n; ++i) {
+      // y[i] + carry fits in SegType, x[i] + y[i] might not with 64-bit segments.
+      const SegType addend = y[i] + carry;
+      carry = x[i] >= SEG_MAX - addend;
+      r[i] = carry ? x[i] - (SEG_MAX - addend) : x[i] + addend;
+    }
+    return carry;
   }
-  int2048 (const int2048 &that) {
-    *this = that;
+  /// Sets r to x - y - borrow over n segments, returns the borrow out. r may alias x or y.
+  static SegType subSegmentsScalar_ (SegType *r, const SegType *x, const SegType *y, int n, SegType borrow) {
+    for (int i = 0; i < n; ++i) {
+      const SegType subtrahend = y[i] + borrow;
+      borrow = x[i] < subtrahend;
+      r[i] = borrow ? x[i] + (SEG_MAX - subtrahend) : x[i] - subtrahend;
+    }
+    return borrow;
   }
-  int2048 (int2048 &&that) {
-    // TODO: test if it works.
-    segments_ = std::move(that.segments_);
-    signbit_ = that.signbit_;
+#ifdef INT2048_SIMD_
+  /* vectorised kernels add a block of segments lane by lane, then resolve the carries between lanes like a binary adder:
+     a lane generates a carry when its sum reaches SEG_MAX and propagates an incoming one when it is exactly SEG_MAX - 1.
+     With g and p the masks of such lanes, the carries into each lane are (g + (g | p) + carry) ^ p,
+     and the bit above the block is the carry out of it. Subtraction is the same with borrows, below 0 and at 0.
+     Lanes that reach SEG_MAX (or drop below 0) then take SEG_MAX off (or on); AVX2 does that with an unsigned min. */
+  static constexpr int SIMD_MIN_SEGMENTS = 8;
+  using CarryKernel_ = SegType (*) (SegType *, const SegType *, const SegType *, int, SegType);
+  __attribute__((target("avx2")))
+  static SegType addSegmentsAvx2_ (SegType *r, const SegType *x, const SegType *y, int n, SegType carry) {
+    const __m256i segMax = _mm256_set1_epi32(SEG_MAX);
+    const __m256i segTop = _mm256_set1_epi32(SEG_MAX - 1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i one = _mm256_set1_epi32(1);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m256i sum = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + i)));
+      const unsigned generate = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(sum, segTop)));
+      const unsigned propagate = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(sum, segTop)));
+      const unsigned carries = generate + (generate | propagate) + carry;
+      const __m256i carryIn = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(carries ^ propagate), lanes), one);
+      const __m256i total = _mm256_add_epi32(sum, carryIn);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), _mm256_min_epu32(total, _mm256_sub_epi32(total, segMax)));
+      carry = carries >> 8;
+    }
+    return addSegmentsScalar_(r + i, x + i, y + i, n - i, carry);
+  }
+  __attribute__((target("avx2")))
+  static SegType subSegmentsAvx2_ (SegType *r, const SegType *x, const SegType *y, int n, SegType borrow) {
+    const __m256i segMax = _mm256_set1_epi32(SEG_MAX);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i one = _mm256_set1_epi32(1);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m256i difference = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i)),
+                                                  _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + i)));
+      const unsigned generate = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(zero, difference)));
+      const unsigned propagate = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(difference, zero)));
+      const unsigned borrows = generate + (generate | propagate) + borrow;
+      const __m256i borrowIn = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(borrows ^ propagate), lanes), one);
+      const __m256i total = _mm256_sub_epi32(difference, borrowIn);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), _mm256_min_epu32(total, _mm256_add_epi32(total, segMax)));
+      borrow = borrows >> 8;
+    }
+    return subSegmentsScalar_(r + i, x + i, y + i, n - i, borrow);
+  }
+  __attribute__((target("avx512f")))
+  static SegType addSegmentsAvx512_ (SegType *r, const SegType *x, const SegType *y, int n, SegType carry) {
+    const __m512i segMax = _mm512_set1_epi32(SEG_MAX);
+    const __m512i segTop = _mm512_set1_epi32(SEG_MAX - 1);
+    const __m512i one = _mm512_set1_epi32(1);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+      const __m512i sum = _mm512_add_epi32(_mm512_loadu_si512(x + i), _mm512_loadu_si512(y + i));
+      const unsigned generate = _mm512_cmpgt_epu32_mask(sum, segTop);
+      const unsigned propagate = _mm512_cmpeq_epi32_mask(sum, segTop);
+      const unsigned carries = generate + (generate | propagate) + carry;
+      const __m512i total = _mm512_mask_add_epi32(sum, static_cast<__mmask16>(carries ^ propagate), sum, one);
+      _mm512_storeu_si512(r + i, _mm512_mask_sub_epi32(total, _mm512_cmpge_epu32_mask(total, segMax), total, segMax));
+      carry = carries >> 16;
+    }
+    return addSegmentsAvx2_(r + i, x + i, y + i, n - i, carry);
+  }
+  __attribute__((target("avx512f")))
+  static SegType subSegmentsAvx512_ (SegType *r, const SegType *x, const SegType *y, int n, SegType borrow) {
+    const __m512i segMax = _mm512_set1_epi32(SEG_MAX);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+      const __m512i difference = _mm512_sub_epi32(_mm512_loadu_si512(x + i), _mm512_loadu_si512(y + i));
+      const unsigned generate = _mm512_cmplt_epi32_mask(difference, zero);
+      const unsigned propagate = _mm512_cmpeq_epi32_mask(difference, zero);
+      const unsigned borrows = generate + (generate | propagate) + borrow;
+      const __m512i total = _mm512_mask_sub_epi32(difference, static_cast<__mmask16>(borrows ^ propagate), difference, one);
+      _mm512_storeu_si512(r + i, _mm512_mask_add_epi32(total, _mm512_cmplt_epi32_mask(total, zero), total, segMax));
+      borrow = borrows >> 16;
+    }
+    return subSegmentsAvx2_(r + i, x + i, y + i, n - i, borrow);
   }
+  /// The widest kernels this CPU runs, looked up once.
+  struct CarryKernels_ {
+    CarryKernel_ add;
+    CarryKernel_ sub;
+  };
+  static const CarryKernels_ &carryKernels_ () {
+    static const CarryKernels_ kernels = [] () -> CarryKernels_ {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")) return { addSegmentsAvx512_, subSegmentsAvx512_ };
+      if (__builtin_cpu_supports("avx2")) return { addSegmentsAvx2_, subSegmentsAvx2_ };
+      return { addSegmentsScalar_, subSegmentsScalar_ };
+    }();
+    return kernels;
+  }
+#endif
+  /// Sets r to x + y + carry over n segments with the fastest kernel available, returns the carry out.
+  static SegType addSegmentsKernel_ (SegType *r, const SegType *x, const SegType *y, int n, SegType carry) {
+    INT2048_COUNT_(addSegments, n);
+#ifdef INT2048_SIMD_
+    if (n >= SIMD_MIN_SEGMENTS) return carryKernels_().add(r, x, y, n, carry);
+#endif
+    return addSegmentsScalar_(r, x, y, n, carry);
+  }
+  /// Sets r to x - y - borrow over n segments with the fastest kernel available, returns the borrow out.
+  static SegType subSegmentsKernel_ (SegType *r, const SegType *x, const SegType *y, int n, SegType borrow) {
+    INT2048_COUNT_(subSegments, n);
+#ifdef INT2048_SIMD_
+    if (n >= SIMD_MIN_SEGMENTS) return carryKernels_().sub(r, x, y, n, borrow);
+#endif
+    return subSegmentsScalar_(r, x, y, n, borrow);
+  }
+  /// Adds b (of size nb) to a (of size na >= nb) in place, returns the carry out of a.
+  static SegType addSegments_ (SegType *a, int na, const SegType *b, int nb) {
+    SegType carry = addSegmentsKernel_(a, a, b, nb, 0);
+    for (int i = nb; carry && i < na; ++i) {
+      carry = a[i] == SEG_MAX - 1;
+      a[i] = carry ? 0 : a[i] + 1;
+    }
+    return carry;
+  }
+  /// Subtracts b (of size nb) from a (of size na >= nb) in place, returns the borrow out of a.
+  static SegType subSegments_ (SegType *a, int na, const SegType *b, int nb) {
+    SegType borrow = subSegmentsKernel_(a, a, b, nb, 0);
+    for (int i = nb; borrow && i < na; ++i) {
+      borrow = a[i] == 0;
+      a[i] = borrow ? SEG_MAX - 1 : a[i] - 1;
+    }
+    return borrow;
+  }
+  /// Size of the segment range without leading zeroes.
+  static int trimmedSize_ (const SegType *a, int n) {
+    while (n > 0 && a[n - 1] == 0) --n;
+    return n;
+  }
+  /// Builds a non-negative int2048 from a little-endian segment range.
+  static int2048 fromSegments_ (const SegType *a, int n) {
+    int2048 res;
+    n = trimmedSize_(a, n);
+    if (n > 0) res.segments_.assign(a, a + n);
+    return res;
+  }
+  /// Multiplies a (of size n) by factor (less than SEG_MAX) in place, returns the carry out of a.
+  static SegType mulSmallSegments_ (SegType *a, int n, SegType factor) {
+    TmpType carry = 0;
+    for (int i = 0; i < n; ++i) {
+      const TmpType product = static_cast<TmpType>(a[i]) * factor + carry;
+      a[i] = product % SEG_MAX;
+      carry = product / SEG_MAX;
+    }
+    return carry;
+  }
+  /** A divisor prepared for repeated division without a hardware divide instruction.
+      Möller and Granlund, Improved Division by Invariant Integers, IEEE Transactions on Computers 60(2), 2011, Algorithm 4. */
+  struct Reciprocal_ {
+    int shift;
+    /// Shifted left until the top bit is set.
+    std::uint64_t divisor;
+    /// floor((2 ** 128 - 1) / divisor) - 2 ** 64.
+    std::uint64_t inverse;
 
-  void read (const std::string &string) {
-    reset_();
-    // this is not IEEE 754. There are no negative zeroes.
-    if (string == "-0" || string == "" || string == "0") {
-      segments_.push_back(0);
+    explicit Reciprocal_ (std::uint64_t d) : shift(__builtin_clzll(d)), divisor(d << shift), inverse(~static_cast<WideType>(0) / divisor) {}
+    /// Divides high * 2 ** 64 + low by divisor, requires high < divisor. Returns the quotient and leaves the remainder in high.
+    std::uint64_t divide (std::uint64_t &high, std::uint64_t low) const {
+      const WideType estimate = static_cast<WideType>(inverse) * high + (static_cast<WideType>(high + 1) << 64 | low);
+      std::uint64_t quotient = estimate >> 64;
+      std::uint64_t remainder = low - quotient * divisor;
+      if (remainder > static_cast<std::uint64_t>(estimate)) {
+        --quotient;
+        remainder += divisor;
+      }
+      if (remainder >= divisor) {
+        ++quotient;
+        remainder -= divisor;
+      }
+      high = remainder;
+      return quotient;
+    }
+    /// Divides remainder * SEG_MAX + seg by the original divisor, with remainder kept shifted left by shift.
+    std::uint64_t divideSegment (std::uint64_t &remainder, SegType seg) const {
+      const WideType current = static_cast<WideType>(remainder) * SEG_MAX + (static_cast<WideType>(seg) << shift);
+      remainder = current >> 64;
+      return divide(remainder, static_cast<std::uint64_t>(current));
+    }
+  };
+  /// Divides a (of size n) by divisor in place in one pass, returns the remainder.
+  static std::uint64_t divSmallSegments_ (SegType *a, int n, std::uint64_t divisor) {
+    const Reciprocal_ reciprocal(divisor);
+    std::uint64_t remainder = 0;
+    for (int i = n - 1; i >= 0; --i) a[i] = reciprocal.divideSegment(remainder, a[i]);
+    return remainder >> reciprocal.shift;
+  }
+  /// Remainder of a (of size n) divided by divisor.
+  static std::uint64_t modSmallSegments_ (const SegType *a, int n, std::uint64_t divisor) {
+    const Reciprocal_ reciprocal(divisor);
+    std::uint64_t remainder = 0;
+    for (int i = n - 1; i >= 0; --i) reciprocal.divideSegment(remainder, a[i]);
+    return remainder >> reciprocal.shift;
+  }
+  /// Multiplies the absolute value of this by factor (less than SEG_MAX) in place.
+  int2048 &mulSmall_ (SegType factor) {
+    const SegType carry = mulSmallSegments_(segments_.data(), segments_.size(), factor);
+    if (carry != 0) segments_.push_back(carry);
+    normalize_();
+    return *this;
+  }
+  /// Divides the absolute value of this by divisor in place, returns the remainder.
+  std::uint64_t divSmall_ (std::uint64_t divisor) {
+    const std::uint64_t remainder = divSmallSegments_(segments_.data(), segments_.size(), divisor);
+    normalize_();
+    return remainder;
+  }
+  /// Multiplies the absolute value of this by factor in place, in one pass over this.
+  int2048 &mulWord_ (std::uint64_t factor) {
+    if (factor < SEG_MAX) return mulSmall_(factor);
+    // at most 3 segments with the 32-bit layout, 2 with the 64-bit one.
+    SegType digits[3];
+    int szFactor = 0;
+    for (; factor > 0; factor /= SEG_MAX) digits[szFactor++] = factor % SEG_MAX;
+    const int szThis = segments_.size();
+    ScratchFrame_ frame;
+    SegType *result = frame.takeZeroed<SegType>(szThis + szFactor);
+    mulSchoolbook_(segments_.data(), szThis, digits, szFactor, result);
+    segments_.assign(result, result + trimmedSize_(result, szThis + szFactor));
+    return *this;
+  }
+  /// Adds 1 to the absolute value of this.
+  void incrementValue_ () {
+    const SegType one = 1;
+    if (addSegments_(segments_.data(), segments_.size(), &one, 1) != 0) segments_.push_back(1);
+  }
+
+  /// Machine integers taken by the single-word fast paths.
+  template <typename T>
+  using EnableIfWord_ = std::enable_if_t<std::is_integral<T>::value && sizeof(T) <= sizeof(std::uint64_t)>;
+  template <typename T>
+  static bool isNegative_ (T value) {
+    if constexpr (std::is_signed<T>::value) {
+      return value < 0;
+    } else {
+      return false;
+    }
+  }
+  /// Absolute value of a machine integer; well defined for the most negative value too.
+  template <typename T>
+  static std::uint64_t magnitude_ (T value) {
+    return isNegative_(value) ? 0ULL - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+  }
+
+  /// Transforms at least this long spread their passes over threads when the parallel policy allows it.
+  static constexpr int PARALLEL_NTT_LENGTH = 1 << 15;
+
+ public:
+  /** Opt-in parallelism for multiplications of more than about 10 ** 5 digits, and the divisions built on them.
+      The policy belongs to the thread that sets it; smaller operations always run serially on the calling thread. */
+  struct ParallelPolicy {
+    /// Threads to spread the work over, including the calling one; 1 is serial.
+    int threads = 1;
+    /** Runs tasks[0, count) and returns once they have all finished, e.g. by handing them to a caller-owned pool.
+        When empty, up to threads - 1 std::threads are started for each batch. */
+    std::function<void (const std::function<void ()> *tasks, int count)> executor;
+  };
+  static void setParallelPolicy (ParallelPolicy policy) {
+    parallelPolicy_() = std::move(policy);
+  }
+  static const ParallelPolicy &parallelPolicy () {
+    return parallelPolicy_();
+  }
+
+  /** What int2048 did on the calling thread since the last resetCounters(), in builds with INT2048_INSTRUMENT defined;
+      all zero otherwise. Work spread over threads by the parallel policy counts on the threads that did it. */
+  struct Counters {
+    /// Segments through the add and subtract kernels.
+    std::uint64_t addSegments = 0;
+    std::uint64_t subSegments = 0;
+    /// Segment-by-segment products of the schoolbook multiplication and squaring kernels.
+    std::uint64_t segmentProducts = 0;
+    /// Heap buffers of values, and blocks of the scratch arena, with their total size.
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+    /// Segment bytes copied by copy construction and copy assignment.
+    std::uint64_t copiedBytes = 0;
+    /// Multiplication and squaring tiers picked, once per (recursive) call of the dispatcher.
+    std::uint64_t mulSchoolbook = 0;
+    std::uint64_t mulKaratsuba = 0;
+    std::uint64_t mulToom3 = 0;
+    std::uint64_t mulNtt = 0;
+    /// Unbalanced products split into slices of the shorter operand.
+    std::uint64_t mulUnbalanced = 0;
+    /// Calls of the squaring dispatcher; these also count toward the tiers above.
+    std::uint64_t squarings = 0;
+    /// Division algorithms picked for magnitudes.
+    std::uint64_t divSchoolbook = 0;
+    std::uint64_t divBurnikelZiegler = 0;
+    std::uint64_t divNewton = 0;
+    /// Long division digits whose estimate was one too large and had to add the divisor back.
+    std::uint64_t divAddBacks = 0;
+    /// Quotient adjustments after Burnikel–Ziegler blocks and Newton estimates.
+    std::uint64_t divCorrections = 0;
+    /// Burnikel–Ziegler 3n/2n steps; each needs at most two of the corrections above.
+    std::uint64_t divBlocks = 0;
+    /// gcd and gcdext steps.
+    std::uint64_t gcdLehmerSteps = 0;
+    std::uint64_t gcdDivisionSteps = 0;
+    std::uint64_t gcdHalfGcd = 0;
+    /// Deepest nesting of the recursive multiplication, division and half-GCD routines.
+    int maxDepth = 0;
+  };
+  static Counters counters () {
+    return countersLocal_();
+  }
+  static void resetCounters () {
+    countersLocal_() = Counters();
+  }
+
+ private:
+  static ParallelPolicy &parallelPolicy_ () {
+    static thread_local ParallelPolicy policy;
+    return policy;
+  }
+  static Counters &countersLocal_ () {
+    static thread_local Counters counters;
+    return counters;
+  }
+  /// Tracks the nesting of the instrumented recursive routines for Counters::maxDepth.
+  class DepthScope_ {
+   public:
+    DepthScope_ () {
+      Counters &counters = countersLocal_();
+      if (++depth_() > counters.maxDepth) counters.maxDepth = depth_();
+    }
+    DepthScope_ (const DepthScope_ &) = delete;
+    DepthScope_ &operator= (const DepthScope_ &) = delete;
+    ~DepthScope_ () {
+      --depth_();
+    }
+
+   private:
+    static int &depth_ () {
+      static thread_local int depth = 0;
+      return depth;
+    }
+  };
+  /// Runs task(i) for each i in [0, count) and returns once all have finished, in parallel if asked to and the policy allows it.
+  template <typename Task>
+  static void runTasks_ (int count, bool parallel, const Task &task) {
+    const ParallelPolicy &policy = parallelPolicy_();
+    if (parallel && count > 1 && policy.executor) {
+      std::vector<std::function<void ()>> tasks;
+      for (int i = 0; i < count; ++i) tasks.emplace_back([&task, i] () { task(i); });
+      return policy.executor(tasks.data(), count);
+    }
+    const int szPool = parallel ? (policy.threads < count ? policy.threads : count) : 1;
+    // worker threads start with a serial policy and their own scratch arena.
+    std::atomic<int> next(0);
+    const auto work = [&] () {
+      for (int i = next++; i < count; i = next++) task(i);
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < szPool; ++i) workers.emplace_back(work);
+    work();
+    for (auto &worker : workers) worker.join();
+  }
+
+  /* number-theoretic transform over three NTT-friendly primes; the exact product is recovered with the CRT.
+     See: https://cp-algorithms.com/algebra/fft.html#number-theoretic-transform */
+  using NttType = std::uint32_t;
+  static constexpr NttType NTT_MOD0 = 998244353; // 119 * 2 ** 23 + 1
+  static constexpr NttType NTT_MOD1 = 167772161; // 5 * 2 ** 25 + 1
+  static constexpr NttType NTT_MOD2 = 469762049; // 7 * 2 ** 26 + 1
+  static constexpr int NTT_PRIMES = 3;
+  /// 3 is a primitive root of all three moduli.
+  static constexpr NttType NTT_ROOT = 3;
+  /// Longest transform supported by all three moduli.
+  static constexpr int NTT_MAX_LENGTH = 1 << 23;
+  /// The transform works on base 10 ** 9 chunks whatever the segment layout, keeping coefficient products within the CRT range.
+  using NttChunkType = std::uint32_t;
+  static constexpr int NTT_CHUNK_LENGTH = 9;
+  static constexpr NttChunkType NTT_CHUNK_MAX = EXP10[NTT_CHUNK_LENGTH];
+  /// Number of chunks covering n segments.
+  static constexpr int nttChunks_ (int n) { return (n * SEG_LENGTH + NTT_CHUNK_LENGTH - 1) / NTT_CHUNK_LENGTH; }
+
+  static NttType powMod_ (std::uint64_t base, std::uint64_t exponent, NttType mod) {
+    std::uint64_t result = 1;
+    base %= mod;
+    while (exponent > 0) {
+      if (exponent & 1) result = result * base % mod;
+      base = base * base % mod;
+      exponent >>= 1;
+    }
+    return result;
+  }
+  /// In-place iterative radix-2 NTT of length n (a power of 2) modulo MOD.
+  template <NttType MOD>
+  static void ntt_ (NttType *a, int n, bool invert) {
+    for (int i = 1, j = 0; i < n; ++i) {
+      int bit = n >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if (i < j) std::swap(a[i], a[j]);
+    }
+    ScratchFrame_ frame;
+    NttType *roots = frame.take<NttType>(n / 2 > 0 ? n / 2 : 1);
+    for (int len = 1; len < n; len <<= 1) {
+      const std::uint64_t w = powMod_(NTT_ROOT, invert ? MOD - 1 - (MOD - 1) / (2 * len) : (MOD - 1) / (2 * len), MOD);
+      roots[0] = 1;
+      for (int k = 1; k < len; ++k) roots[k] = roots[k - 1] * w % MOD;
+      for (int i = 0; i < n; i += 2 * len) {
+        for (int k = 0; k < len; ++k) {
+          const NttType u = a[i + k];
+          const NttType v = static_cast<std::uint64_t>(a[i + k + len]) * roots[k] % MOD;
+          a[i + k] = u + v >= MOD ? u + v - MOD : u + v;
+          a[i + k + len] = u >= v ? u - v : u + MOD - v;
+        }
+      }
+    }
+    if (invert) {
+      const std::uint64_t nInverse = powMod_(n, MOD - 2, MOD);
+      for (int i = 0; i < n; ++i) a[i] = a[i] * nInverse % MOD;
+    }
+  }
+  /// Reduces a modulo MOD into out, zero-pads it to length n and transforms it.
+  template <NttType MOD>
+  static void forwardMod_ (const NttChunkType *a, int na, int n, NttType *out) {
+    for (int i = 0; i < na; ++i) out[i] = a[i] % MOD;
+    for (int i = na; i < n; ++i) out[i] = 0;
+    ntt_<MOD>(out, n, false);
+  }
+  /// Multiplies the transforms fa and fb (which may alias fa) pointwise into fa, and transforms the product back.
+  template <NttType MOD>
+  static void inverseMod_ (NttType *fa, const NttType *fb, int n) {
+    for (int i = 0; i < n; ++i) fa[i] = static_cast<std::uint64_t>(fa[i]) * fb[i] % MOD;
+    ntt_<MOD>(fa, n, true);
+  }
+  /// Same contract as mulSchoolbook_ on chunks, using three-prime NTT. Requires min(na, nb) * NTT_CHUNK_MAX ** 2 < NTT_MOD0 * NTT_MOD1 * NTT_MOD2.
+  static void mulNttChunks_ (const NttChunkType *a, int na, const NttChunkType *b, int nb, NttChunkType *out) {
+    const int n = nttLength_(na + nb);
+    ScratchFrame_ frame;
+    NttType *fa = frame.take<NttType>(NTT_PRIMES * n);
+    // squares take one forward transform per prime.
+    const bool square = a == b && na == nb;
+    NttType *fb = square ? fa : frame.take<NttType>(NTT_PRIMES * n);
+    // the transforms are independent of each other, so they make up the tasks run in parallel: a, then b, per prime.
+    const bool parallel = n >= PARALLEL_NTT_LENGTH;
+    runTasks_(square ? NTT_PRIMES : 2 * NTT_PRIMES, parallel, [&] (int i) {
+      const int prime = i % NTT_PRIMES;
+      if (i < NTT_PRIMES) {
+        forwardPrime_(prime, a, na, n, fa + prime * n);
+      } else {
+        forwardPrime_(prime, b, nb, n, fb + prime * n);
+      }
+    });
+    runTasks_(NTT_PRIMES, parallel, [&] (int prime) { inversePrime_(prime, fa + prime * n, fb + prime * n, n); });
+    combineCrt_(fa, n, na + nb, out);
+  }
+  /// Transform length for a product of nOut chunks.
+  static int nttLength_ (int nOut) {
+    int n = 1;
+    while (n < nOut - 1) n <<= 1;
+    assert(n <= NTT_MAX_LENGTH);
+    return n;
+  }
+  /// forwardMod_ modulo NTT_MOD0, NTT_MOD1 or NTT_MOD2 for prime 0, 1 or 2.
+  static void forwardPrime_ (int prime, const NttChunkType *a, int na, int n, NttType *out) {
+    if (prime == 0) forwardMod_<NTT_MOD0>(a, na, n, out);
+    if (prime == 1) forwardMod_<NTT_MOD1>(a, na, n, out);
+    if (prime == 2) forwardMod_<NTT_MOD2>(a, na, n, out);
+  }
+  /// inverseMod_ modulo NTT_MOD0, NTT_MOD1 or NTT_MOD2 for prime 0, 1 or 2.
+  static void inversePrime_ (int prime, NttType *fa, const NttType *fb, int n) {
+    if (prime == 0) inverseMod_<NTT_MOD0>(fa, fb, n);
+    if (prime == 1) inverseMod_<NTT_MOD1>(fa, fb, n);
+    if (prime == 2) inverseMod_<NTT_MOD2>(fa, fb, n);
+  }
+  /** Recovers nOut chunks of the product from its convolutions modulo each prime, stored n apart in r.
+      A cyclic convolution instead gives the product modulo NTT_CHUNK_MAX ** n - 1, whose carry out of the top wraps around. */
+  static void combineCrt_ (const NttType *r, int n, int nOut, NttChunkType *out, bool cyclic = false) {
+    // Garner's algorithm: x = x0 + x1 * m0 + x2 * m0 * m1.
+    const std::uint64_t m0InvMod1 = powMod_(NTT_MOD0, NTT_MOD1 - 2, NTT_MOD1);
+    const std::uint64_t m0m1InvMod2 = powMod_(static_cast<std::uint64_t>(NTT_MOD0) * NTT_MOD1 % NTT_MOD2, NTT_MOD2 - 2, NTT_MOD2);
+    WideType carry = 0;
+    for (int i = 0; i < nOut; ++i) {
+      if (cyclic || i < nOut - 1) {
+        const std::uint64_t x0 = r[i];
+        const std::uint64_t x1 = (r[n + i] + NTT_MOD1 - x0 % NTT_MOD1) * m0InvMod1 % NTT_MOD1;
+        const std::uint64_t partial = (x0 + x1 * NTT_MOD0) % NTT_MOD2;
+        const std::uint64_t x2 = (r[2 * n + i] + NTT_MOD2 - partial) * m0m1InvMod2 % NTT_MOD2;
+        carry += x0 + static_cast<WideType>(x1) * NTT_MOD0 + static_cast<WideType>(x2) * NTT_MOD0 * NTT_MOD1;
+      }
+      out[i] = carry % NTT_CHUNK_MAX;
+      carry /= NTT_CHUNK_MAX;
+    }
+    // NTT_CHUNK_MAX ** n is 1 modulo NTT_CHUNK_MAX ** n - 1, so the carry out of the top adds in again at the bottom.
+    for (int i = 0; cyclic && carry != 0; i = (i + 1) % n) {
+      carry += out[i];
+      out[i] = carry % NTT_CHUNK_MAX;
+      carry /= NTT_CHUNK_MAX;
+    }
+    assert(carry == 0);
+  }
+  /// Regroups the little-endian base 10 ** fromLength limbs of a into base 10 ** toLength limbs in out (of size m), digit by digit.
+  template <typename From, typename To>
+  static void regroupDigits_ (const From *a, int n, int fromLength, To *out, int m, int toLength) {
+    std::uint64_t current = 0;
+    int digits = 0, j = 0;
+    for (int i = 0; i < n; ++i) {
+      std::uint64_t limb = a[i];
+      for (int k = 0; k < fromLength; ++k, limb /= 10) {
+        current += limb % 10 * EXP10[digits];
+        if (++digits == toLength) {
+          if (j < m) out[j++] = current;
+          current = 0;
+          digits = 0;
+        }
+      }
+    }
+    if (j < m) out[j++] = current;
+    while (j < m) out[j++] = 0;
+  }
+  /// Same contract as mulSchoolbook_, using three-prime NTT on base 10 ** 9 chunks.
+  static void mulNtt_ (const SegType *a, int na, const SegType *b, int nb, SegType *out) {
+#if INT2048_SEGMENT_BITS == 32
+    mulNttChunks_(a, na, b, nb, out);
+#else
+    const int ca = nttChunks_(na), cb = nttChunks_(nb);
+    ScratchFrame_ frame;
+    const bool square = a == b && na == nb;
+    NttChunkType *chunksA = frame.take<NttChunkType>(ca), *chunksB = square ? chunksA : frame.take<NttChunkType>(cb);
+    NttChunkType *product = frame.take<NttChunkType>(ca + cb);
+    regroupDigits_(a, na, SEG_LENGTH, chunksA, ca, NTT_CHUNK_LENGTH);
+    if (!square) regroupDigits_(b, nb, SEG_LENGTH, chunksB, cb, NTT_CHUNK_LENGTH);
+    mulNttChunks_(chunksA, ca, chunksB, cb, product);
+    regroupDigits_(product, ca + cb, NTT_CHUNK_LENGTH, out, na + nb, SEG_LENGTH);
+#endif
+  }
+  /// Same contract as mulSchoolbook_, Karatsuba style. Requires na >= nb.
+  static void mulKaratsuba_ (const SegType *a, int na, const SegType *b, int nb, SegType *out) {
+    const int m = (na + 1) / 2;
+    if (nb <= m) {
+      // b has no upper half: out = a0 * b + a1 * b * SEG_MAX ** m.
+      mulSegments_(a, m, b, nb, out);
+      ScratchFrame_ frame;
+      const int szUpper = na - m + nb;
+      SegType *upper = frame.takeZeroed<SegType>(szUpper);
+      mulSegments_(a + m, na - m, b, nb, upper);
+      addSegments_(out + m, na + nb - m, upper, trimmedSize_(upper, szUpper));
       return;
     }
-    int length = string.length();
-    if (string[0] == '-') {
-      --length;
-      signbit_ = true;
+    // (a0 + a1 x)(b0 + b1 x) = a0 b0 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) x + a1 b1 x ** 2.
+    mulSegments_(a, m, b, m, out);
+    mulSegments_(a + m, na - m, b + m, nb - m, out + 2 * m);
+    ScratchFrame_ frame;
+    // squares share the sum, so the middle product is a square too.
+    const bool square = a == b && na == nb;
+    SegType *sumA = frame.take<SegType>(m + 1), *sumB = square ? sumA : frame.take<SegType>(m + 1);
+    std::memcpy(sumA, a, m * sizeof(SegType));
+    sumA[m] = addSegments_(sumA, m, a + m, na - m);
+    if (!square) {
+      std::memcpy(sumB, b, m * sizeof(SegType));
+      sumB[m] = addSegments_(sumB, m, b + m, nb - m);
+    }
+    const int szSumA = trimmedSize_(sumA, m + 1);
+    const int szSumB = trimmedSize_(sumB, m + 1);
+    const int szMiddle = szSumA + szSumB;
+    SegType *middle = frame.takeZeroed<SegType>(szMiddle);
+    mulSegments_(sumA, szSumA, sumB, szSumB, middle);
+    subSegments_(middle, szMiddle, out, trimmedSize_(out, 2 * m));
+    subSegments_(middle, szMiddle, out + 2 * m, trimmedSize_(out + 2 * m, na + nb - 2 * m));
+    const SegType carry = addSegments_(out + m, na + nb - m, middle, trimmedSize_(middle, szMiddle));
+    assert(carry == 0);
+  }
+  /// Same contract as mulSchoolbook_, Toom-3 style. Requires na >= nb > na / 2.
+  static void mulToom3_ (const SegType *a, int na, const SegType *b, int nb, SegType *out) {
+    // https://en.wikipedia.org/wiki/Toom%E2%80%93Cook_multiplication, evaluation at 0, 1, -1, -2 and infinity (Bodrato).
+    const int k = (na + 2) / 3;
+    const auto part = [k] (const SegType *x, int nx, int i) {
+      const int begin = i * k < nx ? i * k : nx;
+      const int end = (i + 1) * k < nx ? (i + 1) * k : nx;
+      return fromSegments_(x + begin, end - begin);
+    };
+    const int2048 a0 = part(a, na, 0), a1 = part(a, na, 1), a2 = part(a, na, 2);
+    const int2048 b0 = part(b, nb, 0), b1 = part(b, nb, 1), b2 = part(b, nb, 2);
+    int2048 p0 = a0, q0 = b0;
+    p0 += a2, q0 += b2;
+    int2048 p1 = p0, q1 = q0;
+    p1 += a1, q1 += b1;
+    int2048 pm1 = p0, qm1 = q0;
+    pm1 -= a1, qm1 -= b1;
+    int2048 pm2 = pm1, qm2 = qm1;
+    pm2 += a2, qm2 += b2;
+    pm2 += pm2, qm2 += qm2;
+    pm2 -= a0, qm2 -= b0;
+    int2048 r0 = a0, r1 = p1, rm1 = pm1, rm2 = pm2, rInf = a2;
+    r0 *= b0, r1 *= q1, rm1 *= qm1, rm2 *= qm2, rInf *= b2;
+    // interpolation.
+    int2048 r3 = rm2;
+    r3 -= r1;
+    r3.divSmall_(3);
+    r1 -= rm1;
+    r1.divSmall_(2);
+    int2048 r2 = rm1;
+    r2 -= r0;
+    r3.signbit_ = !r3.signbit_;
+    r3 += r2;
+    r3.divSmall_(2);
+    r3 += rInf;
+    r3 += rInf;
+    r2 += r1;
+    r2 -= rInf;
+    r1 -= r3;
+    const int2048 *coefficients[] = { &r0, &r1, &r2, &r3, &rInf };
+    for (int i = 0; i < 5; ++i) {
+      const int2048 &coefficient = *coefficients[i];
+      if (coefficient.isNull_()) continue;
+      assert(!coefficient.signbit_);
+      const SegType carry = addSegments_(out + i * k, na + nb - i * k, coefficient.segments_.data(), coefficient.segments_.size());
+      assert(carry == 0);
+    }
+  }
+  /// Multiplies a (of size na) by b (of size nb) into out (of size na + nb, zero-filled), picking an algorithm by size.
+  static void mulSegments_ (const SegType *a, int na, const SegType *b, int nb, SegType *out) {
+    if (a == b && na == nb) return sqrSegments_(a, na, out);
+    INT2048_DEPTH_();
+    if (na < nb) {
+      std::swap(a, b);
+      std::swap(na, nb);
     }
-    int size = length / SEG_LENGTH + (length % SEG_LENGTH > 0 ? 1 : 0);
-    segments_.reserve(size);
-    SegType current = 0;
-    for (int i = string.length() - 1; i >= 0; --i) {
-      if (string[i] == '-') continue;
-      const int num = string[i] - '0';
-      const int offset = string.length() - 1 - i;
-      const int segId = offset / SEG_LENGTH;
-      const int pos = offset % SEG_LENGTH;
-      current += num * EXP10[pos];
-      if (pos == SEG_LENGTH - 1) {
-        segments_.push_back(current);
-        current = 0;
+    if (nb < KARATSUBA_THRESHOLD) {
+      INT2048_COUNT_(mulSchoolbook, 1);
+      mulSchoolbook_(a, na, b, nb, out);
+    } else if (nb >= NTT_THRESHOLD && nttChunks_(na) + nttChunks_(nb) - 1 <= NTT_MAX_LENGTH) {
+      INT2048_COUNT_(mulNtt, 1);
+      mulNtt_(a, na, b, nb, out);
+    } else if (na >= 2 * nb) {
+      INT2048_COUNT_(mulUnbalanced, 1);
+      // unbalanced: multiply b by nb-sized slices of a.
+      ScratchFrame_ frame;
+      SegType *slice = frame.take<SegType>(2 * nb);
+      for (int offset = 0; offset < na; offset += nb) {
+        const int szSlice = na - offset < nb ? na - offset : nb;
+        std::memset(slice, 0, 2 * nb * sizeof(SegType));
+        mulSegments_(a + offset, szSlice, b, nb, slice);
+        addSegments_(out + offset, na + nb - offset, slice, trimmedSize_(slice, szSlice + nb));
       }
+    } else if (nb >= TOOM3_THRESHOLD) {
+      INT2048_COUNT_(mulToom3, 1);
+      mulToom3_(a, na, b, nb, out);
+    } else {
+      INT2048_COUNT_(mulKaratsuba, 1);
+      mulKaratsuba_(a, na, b, nb, out);
     }
-    if (current != 0) segments_.push_back(current);
+  }
+  /// Squares a (of size n) into out (of size 2 n, zero-filled), picking an algorithm by size.
+  static void sqrSegments_ (const SegType *a, int n, SegType *out) {
+    INT2048_DEPTH_();
+    INT2048_COUNT_(squarings, 1);
+    if (n < KARATSUBA_THRESHOLD) {
+      INT2048_COUNT_(mulSchoolbook, 1);
+      sqrSchoolbook_(a, n, out);
+    } else if (n >= NTT_THRESHOLD && 2 * nttChunks_(n) - 1 <= NTT_MAX_LENGTH) {
+      INT2048_COUNT_(mulNtt, 1);
+      mulNtt_(a, n, a, n, out);
+    } else if (n >= TOOM3_THRESHOLD) {
+      INT2048_COUNT_(mulToom3, 1);
+      mulToom3_(a, n, a, n, out);
+    } else {
+      INT2048_COUNT_(mulKaratsuba, 1);
+      mulKaratsuba_(a, n, a, n, out);
+    }
+  }
+
+ public:
+  /** Multiplies many values by one factor. The factor's NTT transforms are kept for each transform length used,
+      so a large apply only transforms the other operand, multiplies pointwise and transforms back.
+      Operands below the NTT threshold take the usual algorithms. apply fills the cache, so one object serves one thread. */
+  class PreparedMultiplier {
+   public:
+    explicit PreparedMultiplier (const int2048 &factor)
+        : segments_(factor.segments_.begin(), factor.segments_.end()), signbit_(factor.signbit_ && !factor.isNull_()) {
+#if INT2048_SEGMENT_BITS == 32
+      chunks_ = segments_;
+#else
+      chunks_.resize(nttChunks_(segments_.size()));
+      regroupDigits_(segments_.data(), segments_.size(), SEG_LENGTH, chunks_.data(), chunks_.size(), NTT_CHUNK_LENGTH);
+#endif
+    }
+    /// Returns factor * x.
+    int2048 apply (const int2048 &x) {
+      const int na = segments_.size();
+      const int nb = x.segments_.size();
+      ScratchFrame_ frame;
+      SegType *out = frame.takeZeroed<SegType>(na + nb);
+      const int ca = chunks_.size();
+      const int cb = nttChunks_(nb);
+      if (na < NTT_THRESHOLD || nb < NTT_THRESHOLD || ca + cb - 1 > NTT_MAX_LENGTH) {
+        mulSegments_(segments_.data(), na, x.segments_.data(), nb, out);
+      } else {
+#if INT2048_SEGMENT_BITS == 32
+        const NttChunkType *chunksB = x.segments_.data();
+        NttChunkType *product = out;
+#else
+        NttChunkType *chunksB = frame.take<NttChunkType>(cb);
+        NttChunkType *product = frame.take<NttChunkType>(ca + cb);
+        regroupDigits_(x.segments_.data(), nb, SEG_LENGTH, chunksB, cb, NTT_CHUNK_LENGTH);
+#endif
+        const int n = nttLength_(ca + cb);
+        const NttType *fa = transforms_(n);
+        NttType *fb = frame.take<NttType>(NTT_PRIMES * n);
+        runTasks_(NTT_PRIMES, n >= PARALLEL_NTT_LENGTH, [&] (int prime) {
+          forwardPrime_(prime, chunksB, cb, n, fb + prime * n);
+          inversePrime_(prime, fb + prime * n, fa + prime * n, n);
+        });
+        combineCrt_(fb, n, ca + cb, product);
+#if INT2048_SEGMENT_BITS == 64
+        regroupDigits_(product, ca + cb, NTT_CHUNK_LENGTH, out, na + nb, SEG_LENGTH);
+#endif
+      }
+      int2048 res = fromSegments_(out, na + nb);
+      res.signbit_ = signbit_ != x.signbit_ && !res.isNull_();
+      return res;
+    }
+
+   private:
+    /// Transforms of the factor at length n, modulo each prime in turn; computed on first use.
+    const NttType *transforms_ (int n) {
+      std::size_t log = 0;
+      while ((1 << log) < n) ++log;
+      if (cache_.size() <= log) cache_.resize(log + 1);
+      std::vector<NttType> &transforms = cache_[log];
+      if (transforms.empty()) {
+        transforms.resize(NTT_PRIMES * n);
+        runTasks_(NTT_PRIMES, n >= PARALLEL_NTT_LENGTH, [&] (int prime) {
+          forwardPrime_(prime, chunks_.data(), chunks_.size(), n, transforms.data() + prime * n);
+        });
+      }
+      return transforms.data();
+    }
+
+    // divNewton_ keeps the transforms of the divisor for its wrapped products.
+    friend class int2048;
+
+    std::vector<SegType> segments_;
+    bool signbit_;
+    /// Digits of the factor in base 10 ** 9 chunks, as the transforms take them.
+    std::vector<NttChunkType> chunks_;
+    /// Indexed by the binary logarithm of the transform length.
+    std::vector<std::vector<NttType>> cache_;
+  };
+
+  int2048 () {
+    segments_.push_back(0);
+  }
+  int2048 (long long number) {
+    setValue_(number);
+  }
+  int2048 (const std::string &string) {
+    read(string);
+  }
+  int2048 (const int2048 &that) {
+    *this = that;
+  }
+  /// Leaves that as 0.
+  int2048 (int2048 &&that) noexcept : segments_(std::move(that.segments_)), signbit_(that.signbit_) {
+    that.resetTo_(0);
+  }
+  /** These keep the heap storage of the value in resource, e.g. to let a batch of values share one arena.
+      Compound assignments and copy assignment keep the resource of their left operand, while move assignment takes
+      the storage of its right operand along with its resource; copies and fresh results use new[] again. */
+  int2048 (long long number, std::pmr::memory_resource *resource) : segments_(resource) {
+    setValue_(number);
+  }
+  int2048 (const int2048 &that, std::pmr::memory_resource *resource) : segments_(resource) {
+    *this = that;
+  }
+  /// Resource the heap storage of this comes from; nullptr for new[].
+  std::pmr::memory_resource *resource () const {
+    return segments_.resource();
+  }
+
+  void read (std::string_view string) {
+    // this is not IEEE 754. There are no negative zeroes; malformed input reads as 0.
+    if (from_chars(string.data(), string.data() + string.size(), *this).ec != std::errc()) resetTo_(0);
   }
   void print () const {
     std::cout << *this;
@@ -193,67 +1298,127 @@ class int2048 {
   int2048 &add (const int2048 &that) {
     return signbit_ == that.signbit_ ? addValue_(that) : subValue_(that);
   }
-  friend int2048 &add (const int2048 &a, const int2048 &b) {
+  friend int2048 add (const int2048 &a, const int2048 &b) {
     return a + b;
   }
 
   int2048 &minus (const int2048 &that) {
     return signbit_ != that.signbit_ ? addValue_(that) : subValue_(that);
   }
-  friend int2048 &minus (const int2048 &minuend, const int2048 &subtrahend) {
+  friend int2048 minus (const int2048 &minuend, const int2048 &subtrahend) {
     return minuend - subtrahend;
   }
 
   int2048 &operator= (const int2048 &that) {
+    INT2048_COUNT_(copiedBytes, that.segments_.size() * sizeof(SegType));
     segments_ = that.segments_;
     signbit_ = that.signbit_;
     return *this;
   }
+  int2048 &operator= (int2048 &&that) noexcept {
+    // swapping hands our old buffer to that, so it stays a valid number.
+    swap(that);
+    return *this;
+  }
+  void swap (int2048 &that) noexcept {
+    segments_.swap(that.segments_);
+    std::swap(signbit_, that.signbit_);
+  }
+  friend void swap (int2048 &a, int2048 &b) noexcept {
+    a.swap(b);
+  }
 
+ private:
+  /// Move assignment that copies instead when that lives in another memory resource, so this stays in its own.
+  int2048 &assignKeepingResource_ (int2048 &&that) {
+    if (segments_.resource() != that.segments_.resource()) return *this = that;
+    return *this = std::move(that);
+  }
+
+ public:
   int2048 &operator+= (const int2048 &that) {
     return add(that);
   }
-  friend int2048 &operator+ (const int2048 &a, const int2048 &b) {
-    // TODO: are there ways to implement this without using `new`, `malloc`, or their relatives?
-    return (new int2048(a))->add(b);
+  // the rvalue overloads reuse the buffer of a temporary operand.
+  friend int2048 operator+ (const int2048 &a, const int2048 &b) {
+    int2048 res(a);
+    res.add(b);
+    return res;
+  }
+  friend int2048 operator+ (int2048 &&a, const int2048 &b) {
+    a.add(b);
+    return std::move(a);
+  }
+  friend int2048 operator+ (const int2048 &a, int2048 &&b) {
+    b.add(a);
+    return std::move(b);
+  }
+  friend int2048 operator+ (int2048 &&a, int2048 &&b) {
+    a.add(b);
+    return std::move(a);
   }
 
   int2048 &operator-= (const int2048 &that) {
     return minus(that);
   }
-  friend int2048 &operator- (const int2048 &minuend, const int2048 &subtrahend) {
-    return (new int2048(minuend))->minus(subtrahend);
+  friend int2048 operator- (const int2048 &minuend, const int2048 &subtrahend) {
+    int2048 res(minuend);
+    res.minus(subtrahend);
+    return res;
+  }
+  friend int2048 operator- (int2048 &&minuend, const int2048 &subtrahend) {
+    minuend.minus(subtrahend);
+    return std::move(minuend);
+  }
+  friend int2048 operator- (const int2048 &minuend, int2048 &&subtrahend) {
+    // a - b = -(b - a).
+    subtrahend.minus(minuend);
+    if (!subtrahend.isNull_()) subtrahend.signbit_ = !subtrahend.signbit_;
+    return std::move(subtrahend);
+  }
+  friend int2048 operator- (int2048 &&minuend, int2048 &&subtrahend) {
+    minuend.minus(subtrahend);
+    return std::move(minuend);
   }
 
+  /// Squares this in place; operator*= takes this path too when both operands have the same magnitude.
+  int2048 &square () {
+    signbit_ = false;
+    if (isNull_()) return *this;
+    const int szThis = segments_.size();
+    ScratchFrame_ frame;
+    SegType *result = frame.takeZeroed<SegType>(2 * szThis);
+    sqrSegments_(segments_.data(), szThis, result);
+    segments_.assign(result, result + trimmedSize_(result, 2 * szThis));
+    return *this;
+  }
+  friend int2048 sqr (int2048 a) {
+    a.square();
+    return a;
+  }
   int2048 &operator*= (const int2048 &that) {
-    // https://treskal.com/s/masters-thesis.pdf, Algorithm 2.3. Retrieved 2021/11/12.
     if (isNull_()) return *this;
     if (that.isNull_()) return resetTo_(0);
-    if (that.signbit_) signbit_ = !signbit_;
-    int2048 thatSnapshot = that;
-    std::vector<SegType> result;
     const int szThis = segments_.size();
     const int szThat = that.segments_.size();
-    const int szResult = szThis + szThat + 1;
-    result.reserve(szResult);
-    for (int i = 0; i < szResult; ++i) result.push_back(0);
-    for (int i = 0; i < szThis; ++i) {
-      TmpType q = 0;
-      for (int j = 0; j < szThat; ++j) {
-        TmpType tmp;
-        tmp = static_cast<TmpType>(result[i + j]) + q + static_cast<TmpType>(segments_[i]) * static_cast<TmpType>(that.segments_[j]);
-        result[i + j] = tmp % SEG_MAX;
-        q = tmp / SEG_MAX;
-      }
-      result[i + szThat] = q;
-    };
-    segments_ = std::move(result);
-    normalize_();
-    segments_.shrink_to_fit();
+    // a * a reaches here with a copy of a, so squares are found by value as well as by address.
+    if (this == &that || (szThis == szThat && std::memcmp(segments_.data(), that.segments_.data(), szThis * sizeof(SegType)) == 0)) {
+      const bool negative = signbit_ != that.signbit_;
+      square();
+      signbit_ = negative;
+      return *this;
+    }
+    if (that.signbit_) signbit_ = !signbit_;
+    // the product goes to scratch first: that may alias this, and assigning it back reuses our buffer when it is large enough.
+    ScratchFrame_ frame;
+    SegType *result = frame.takeZeroed<SegType>(szThis + szThat);
+    mulSegments_(segments_.data(), szThis, that.segments_.data(), szThat, result);
+    segments_.assign(result, result + trimmedSize_(result, szThis + szThat));
     return *this;
   }
-  friend int2048 &operator* (const int2048 &a, const int2048 &b) {
-    return *(new int2048(a)) *= b;
+  friend int2048 operator* (int2048 a, const int2048 &b) {
+    a *= b;
+    return a;
   }
 
  private:
@@ -262,43 +1427,18 @@ class int2048 {
     T quotient;
     T remainder;
   };
-  static DivisionResult_<int2048> divSubroutine_ (const int2048 &divisor, const int2048 &dividend) {
-    // https://treskal.com/s/masters-thesis.pdf, Algorithm 3.1. Retrieved 2021/11/12.
-    const int szDivisor = divisor.segments_.size();
-    const int szDividend = dividend.segments_.size();
-    assert(szDivisor <= szDividend + 1);
-    assert(dividend.segments_.back() >= SEG_MAX / 2);
-    if (szDivisor == 1) {
-      if (szDividend > 1) return { 0, dividend };
-      return { divisor.segments_[0] / dividend.segments_[0], divisor.segments_[0] % dividend.segments_[0] };
-    }
-    const bool shouldSub = szDivisor == szDividend + 1 && divisor.segments_.back() >= dividend.segments_.back();
-    if (shouldSub) {
-      int2048 mutDivisor = divisor;
-      mutDivisor.subValue_(dividend, /* lshift */ true);
-      auto result = divSubroutine_(mutDivisor, dividend);
-      result.quotient += SEG_MAX;
-      return result;
-    }
-    TmpType q = static_cast<TmpType>(SEG_MAX) * static_cast<TmpType>(divisor.seg_(szDividend)) + static_cast<TmpType>(divisor.seg_(szDividend - 1));
-    q /= static_cast<TmpType>(dividend.segments_.back());
-    int2048 t = dividend;
-    t *= q;
-    while (t > divisor) {
-      --q;
-      t -= dividend;
-    }
-    DivisionResult_<int2048> res { q, divisor };
-    res.remainder -= t;
-    return res;
-  }
   /// Right shifts by SEG_MAX ** cntSegments, and returns quotient and remainder.
   DivisionResult_<int2048> rshift_ (int cntSegments) const {
     DivisionResult_<int2048> res;
+    const int szThis = segments_.size();
+    if (cntSegments >= szThis) {
+      res.remainder = *this;
+      return res;
+    }
     res.remainder.reset_();
     res.quotient.reset_();
     res.remainder.segments_.reserve(cntSegments);
-    res.quotient.segments_.reserve(segments_.size() - cntSegments);
+    res.quotient.segments_.reserve(szThis - cntSegments);
     auto it = segments_.begin();
     for (int i = 0; i < cntSegments; ++i) {
       res.remainder.segments_.push_back(*it);
@@ -306,72 +1446,1153 @@ class int2048 {
     }
     for (; it != segments_.end(); ++it) res.quotient.segments_.push_back(*it);
     // no need to normalize quotient here.
+    if (cntSegments == 0) res.remainder.segments_.push_back(0);
     res.remainder.normalize_();
     return res;
   }
+  /** Divides u (of size nu, followed by one more zero segment) by v (of size nv >= 2, leading segment at least SEG_MAX / 2).
+      Writes the nu - nv + 1 quotient segments into q and leaves the remainder in the lowest nv segments of u. */
+  static void divKnuth_ (SegType *u, int nu, const SegType *v, int nv, SegType *q) {
+    // Knuth, The Art of Computer Programming, volume 2, section 4.3.1, Algorithm D.
+    const TmpType vTop = v[nv - 1];
+    const TmpType vNext = v[nv - 2];
+    for (int j = nu - nv; j >= 0; --j) {
+      const TmpType numerator = static_cast<TmpType>(u[j + nv]) * SEG_MAX + u[j + nv - 1];
+      TmpType qHat = numerator / vTop;
+      TmpType rHat = numerator % vTop;
+      while (qHat >= SEG_MAX || qHat * vNext > rHat * SEG_MAX + static_cast<TmpType>(u[j + nv - 2])) {
+        --qHat;
+        rHat += vTop;
+        if (rHat >= SEG_MAX) break;
+      }
+      // u[j .. j + nv] -= qHat * v.
+      TmpType carry = 0, borrow = 0;
+      for (int i = 0; i < nv; ++i) {
+        const TmpType product = qHat * static_cast<TmpType>(v[i]) + carry;
+        carry = product / SEG_MAX;
+        TmpType difference = static_cast<TmpType>(u[i + j]) - product % SEG_MAX - borrow;
+        borrow = difference < 0;
+        u[i + j] = borrow ? difference + SEG_MAX : difference;
+      }
+      const TmpType top = static_cast<TmpType>(u[j + nv]) - carry - borrow;
+      if (top < 0) {
+        // qHat was one too large, which happens with probability about 2 / SEG_MAX.
+        INT2048_COUNT_(divAddBacks, 1);
+        --qHat;
+        u[j + nv] = top + SEG_MAX;
+        u[j + nv] = (u[j + nv] + addSegments_(u + j, nv, v, nv)) % SEG_MAX;
+      } else {
+        u[j + nv] = top;
+      }
+      q[j] = qHat;
+    }
+  }
+  /// Long division returning the remainder as well, for numerator and denominator non-negative.
+  static DivisionResult_<int2048> divModSchoolbook_ (const int2048 &numerator, const int2048 &denominator) {
+    DivisionResult_<int2048> res;
+    if (cmpValue_(numerator, denominator) < 0) {
+      res.remainder = numerator;
+      return res;
+    }
+    const int szDenominator = denominator.segments_.size();
+    if (szDenominator == 1) {
+      res.quotient = numerator;
+      // a 64-bit segment may not fit in long long, so the remainder is stored directly.
+      res.remainder.segments_[0] = res.quotient.divSmall_(denominator.segments_[0]);
+      return res;
+    }
+    // normalize so that the leading segment of the denominator is at least SEG_MAX / 2.
+    const SegType factor = SEG_MAX / (denominator.segments_.back() + 1);
+    const int szNumerator = numerator.segments_.size();
+    ScratchFrame_ frame;
+    // room for the carry out of the normalization and the extra zero segment divKnuth_ expects.
+    SegType *u = frame.take<SegType>(szNumerator + 2);
+    SegType *v = frame.take<SegType>(szDenominator);
+    std::memcpy(u, numerator.segments_.data(), szNumerator * sizeof(SegType));
+    std::memcpy(v, denominator.segments_.data(), szDenominator * sizeof(SegType));
+    u[szNumerator] = mulSmallSegments_(u, szNumerator, factor);
+    u[szNumerator + 1] = 0;
+    const SegType carry = mulSmallSegments_(v, szDenominator, factor);
+    assert(carry == 0 && v[szDenominator - 1] >= SEG_MAX / 2);
+    const int szU = u[szNumerator] != 0 ? szNumerator + 1 : szNumerator;
+    res.quotient.segments_.assign(szU - szDenominator + 1, 0);
+    divKnuth_(u, szU, v, szDenominator, res.quotient.segments_.data());
+    res.quotient.normalize_();
+    divSmallSegments_(u, szDenominator, factor);
+    res.remainder = fromSegments_(u, szDenominator);
+    return res;
+  }
+  /// Burnikel–Ziegler 2n/1n step. Requires numerator < denominator * SEG_MAX ** n, and denominator normalized with n segments.
+  static DivisionResult_<int2048> div2n1n_ (const int2048 &numerator, const int2048 &denominator, int n) {
+    INT2048_DEPTH_();
+    // Burnikel and Ziegler, Fast Recursive Division (MPI-I-98-1-022), Algorithm 1.
+    if (n % 2 == 1 || n < BZ_DIV_THRESHOLD) return divModSchoolbook_(numerator, denominator);
+    if (n >= NEWTON_DIV_THRESHOLD) return divNewton_(numerator, denominator);
+    const int half = n / 2;
+    auto lowest = numerator.rshift_(half);
+    auto upper = div3n2n_(lowest.quotient, denominator, half);
+    int2048 &next = upper.remainder;
+    next.shiftSegments_(half);
+    next.addValue_(lowest.remainder);
+    auto lower = div3n2n_(next, denominator, half);
+    upper.quotient.shiftSegments_(half);
+    upper.quotient.addValue_(lower.quotient);
+    return { upper.quotient, lower.remainder };
+  }
+  /// Burnikel–Ziegler 3n/2n step on half-segment blocks. Requires numerator < denominator * SEG_MAX ** half, and denominator normalized with 2 * half segments.
+  static DivisionResult_<int2048> div3n2n_ (const int2048 &numerator, const int2048 &denominator, int half) {
+    // Burnikel and Ziegler, Fast Recursive Division (MPI-I-98-1-022), Algorithm 2.
+    INT2048_COUNT_(divBlocks, 1);
+    const auto splitNumerator = numerator.rshift_(half);
+    const auto splitDenominator = denominator.rshift_(half);
+    const int2048 &upperDenominator = splitDenominator.quotient;
+    DivisionResult_<int2048> res;
+    if (cmpValue_(splitNumerator.quotient.rshift_(half).quotient, upperDenominator) < 0) {
+      res = div2n1n_(splitNumerator.quotient, upperDenominator, half);
+    } else {
+      // the quotient estimate saturates at SEG_MAX ** half - 1.
+      res.quotient.segments_.assign(half, SEG_MAX - 1);
+      res.remainder = splitNumerator.quotient;
+      int2048 shifted = upperDenominator;
+      shifted.shiftSegments_(half);
+      res.remainder.subValue_(shifted);
+      res.remainder.add(upperDenominator);
+    }
+    int2048 product = res.quotient;
+    product *= splitDenominator.remainder;
+    res.remainder.shiftSegments_(half);
+    res.remainder.add(splitNumerator.remainder);
+    res.remainder.minus(product);
+    // at most two corrections are needed.
+    for (int corrections = 0; res.remainder.signbit_ && !res.remainder.isNull_(); ++corrections) {
+      assert(corrections < 2);
+      INT2048_COUNT_(divCorrections, 1);
+      res.quotient.subValue_(1);
+      res.remainder.add(denominator);
+    }
+    res.remainder.signbit_ = false;
+    return res;
+  }
+  /// Divides numerator by denominator with Burnikel–Ziegler recursion, both non-negative and denominator not null.
+  static DivisionResult_<int2048> divBurnikelZiegler_ (const int2048 &numerator, const int2048 &denominator) {
+    // Burnikel and Ziegler, Fast Recursive Division (MPI-I-98-1-022), Section 4.
+    const int szDenominator = denominator.segments_.size();
+    // the block size n = j * 2 ** k stays even while halving down to fewer than BZ_DIV_THRESHOLD segments.
+    int m = 1;
+    while (m * BZ_DIV_THRESHOLD <= szDenominator) m <<= 1;
+    const int n = (szDenominator + m - 1) / m * m;
+    // normalize as divModSchoolbook_ does; a larger factor could carry b into one more segment than the blocks expect.
+    const SegType factor = SEG_MAX / (denominator.segments_.back() + 1);
+    int2048 a = numerator, b = denominator;
+    a.mulSmall_(factor);
+    b.mulSmall_(factor);
+    assert(static_cast<int>(b.segments_.size()) == szDenominator && b.segments_.back() >= SEG_MAX / 2);
+    a.shiftSegments_(n - szDenominator);
+    b.shiftSegments_(n - szDenominator);
+    // a has at most t * n - 1 segments, so its leading block is less than b.
+    const int szA = a.segments_.size();
+    const int t = (szA + n) / n > 2 ? (szA + n) / n : 2;
+    auto split = a.rshift_((t - 2) * n);
+    int2048 block = split.quotient;
+    int2048 rest = split.remainder;
+    DivisionResult_<int2048> res;
+    for (int i = t - 2; i >= 0; --i) {
+      auto step = div2n1n_(block, b, n);
+      res.quotient.shiftSegments_(n);
+      res.quotient.addValue_(step.quotient);
+      if (i == 0) {
+        res.remainder = std::move(step.remainder);
+        break;
+      }
+      auto nextSplit = rest.rshift_((i - 1) * n);
+      block = std::move(step.remainder);
+      block.shiftSegments_(n);
+      block.addValue_(nextSplit.quotient);
+      rest = std::move(nextSplit.remainder);
+    }
+    res.remainder.shiftSegments_(szDenominator - n);
+    res.remainder.divSmall_(factor);
+    return res;
+  }
+  /// Multiplies the absolute value by SEG_MAX ** count, or truncates it by SEG_MAX ** -count if count is negative.
+  int2048 &shiftSegments_ (int count) {
+    if (isNull_() || count == 0) return *this;
+    if (count > 0) {
+      segments_.insert(segments_.begin(), count, 0);
+      return *this;
+    }
+    if (-count >= static_cast<int>(segments_.size())) return resetTo_(0);
+    segments_.erase(segments_.begin(), segments_.begin() - count);
+    return *this;
+  }
+  /// Adds the chunks of a into out (of size n) modulo NTT_CHUNK_MAX ** n - 1.
+  static void foldChunks_ (const NttChunkType *a, int na, int n, NttChunkType *out) {
+    for (int start = 0; start < na; start += n) {
+      std::uint64_t carry = 0;
+      for (int i = 0; i < n; ++i) {
+        carry += out[i] + (start + i < na ? a[start + i] : 0);
+        out[i] = carry % NTT_CHUNK_MAX;
+        carry /= NTT_CHUNK_MAX;
+      }
+      for (int i = 0; carry != 0; i = (i + 1) % n) {
+        carry += out[i];
+        out[i] = carry % NTT_CHUNK_MAX;
+        carry /= NTT_CHUNK_MAX;
+      }
+    }
+  }
+  /// Reduces the absolute value of x modulo NTT_CHUNK_MAX ** n - 1 into the n chunks of out.
+  static void foldValue_ (const int2048 &x, int n, NttChunkType *out) {
+    std::fill(out, out + n, 0);
+#if INT2048_SEGMENT_BITS == 32
+    foldChunks_(x.segments_.data(), x.segments_.size(), n, out);
+#else
+    ScratchFrame_ frame;
+    const int chunks = nttChunks_(x.segments_.size());
+    NttChunkType *regrouped = frame.take<NttChunkType>(chunks);
+    regroupDigits_(x.segments_.data(), x.segments_.size(), SEG_LENGTH, regrouped, chunks, NTT_CHUNK_LENGTH);
+    foldChunks_(regrouped, chunks, n, out);
+#endif
+  }
+  /// Transform length of mulSubWrapped_ for results within SEG_MAX ** size in absolute value, or 0 if NTT does not apply.
+  static int wrappedLength_ (int size) {
+    if (size < NTT_THRESHOLD) return 0;
+    // the sign of the result takes the top half of the range.
+    const int n = nttLength_(nttChunks_(size) + 3);
+    return n <= NTT_MAX_LENGTH ? n : 0;
+  }
+  /** Returns c - a * b for non-negative c and a, computing the product modulo NTT_CHUNK_MAX ** n - 1 with cyclic transforms
+      of length n and reusing those of b. Only correct when the result is less than NTT_CHUNK_MAX ** n / 2 in absolute value,
+      which lets the division steps below, whose products nearly cancel with c, transform at about the size of b. */
+  static int2048 mulSubWrapped_ (const int2048 &c, const int2048 &a, PreparedMultiplier &b, int n) {
+    ScratchFrame_ frame;
+    NttChunkType *folded = frame.take<NttChunkType>(n), *product = frame.take<NttChunkType>(n);
+    NttType *fa = frame.take<NttType>(NTT_PRIMES * n);
+    const NttType *fb = b.transforms_(n);
+    foldValue_(a, n, folded);
+    runTasks_(NTT_PRIMES, n >= PARALLEL_NTT_LENGTH, [&] (int prime) {
+      forwardPrime_(prime, folded, n, n, fa + prime * n);
+      inversePrime_(prime, fa + prime * n, fb + prime * n, n);
+    });
+    combineCrt_(fa, n, n, product, true);
+    foldValue_(c, n, folded);
+    std::int64_t borrow = 0;
+    for (int i = 0; i < n; ++i) {
+      borrow += static_cast<std::int64_t>(folded[i]) - product[i];
+      folded[i] = (borrow + NTT_CHUNK_MAX) % NTT_CHUNK_MAX;
+      borrow = borrow < 0 ? -1 : 0;
+    }
+    // the borrow out of the top wrapped around to NTT_CHUNK_MAX ** n, one more than the modulus; the difference is positive then.
+    for (int i = 0; borrow != 0; ++i) {
+      borrow = folded[i] == 0 ? -1 : 0;
+      folded[i] = borrow != 0 ? NTT_CHUNK_MAX - 1 : folded[i] - 1;
+    }
+    // residues in the top half of the range stand for negative results, whose absolute value is the modulus minus the residue.
+    const bool negative = folded[n - 1] >= NTT_CHUNK_MAX / 2;
+    if (negative) {
+      for (int i = 0; i < n; ++i) folded[i] = NTT_CHUNK_MAX - 1 - folded[i];
+    }
+#if INT2048_SEGMENT_BITS == 32
+    int2048 res = fromSegments_(folded, n);
+#else
+    const int segments = (n * NTT_CHUNK_LENGTH + SEG_LENGTH - 1) / SEG_LENGTH;
+    SegType *out = frame.take<SegType>(segments);
+    regroupDigits_(folded, n, NTT_CHUNK_LENGTH, out, segments, SEG_LENGTH);
+    int2048 res = fromSegments_(out, segments);
+#endif
+    res.signbit_ = negative && !res.isNull_();
+    return res;
+  }
+  /** Approximates SEG_MAX ** (n + precision) / divisor within a few units, where n is the size of divisor.
+      prepared, if given, holds the transforms of divisor for the wrapped products. */
+  static int2048 reciprocal_ (const int2048 &divisor, int precision, PreparedMultiplier *prepared = nullptr) {
+    INT2048_DEPTH_();
+    // https://en.wikipedia.org/wiki/Division_algorithm#Newton%E2%80%93Raphson_division
+    const int n = divisor.segments_.size();
+    if (n > precision + 2) {
+      // only the leading precision + 2 segments of divisor can affect the result.
+      int2048 truncated = divisor;
+      truncated.shiftSegments_(precision + 2 - n);
+      return reciprocal_(truncated, precision);
+    }
+    int2048 power = 1;
+    power.shiftSegments_(n + precision);
+    if (precision <= NEWTON_BASE_PRECISION) return std::move(divModSchoolbook_(power, divisor).quotient);
+    // each Newton step doubles the number of correct segments: x += x * (SEG_MAX ** (n + precision) - divisor * x) / SEG_MAX ** (n + precision).
+    const int half = precision / 2 + 1;
+    int2048 x = reciprocal_(divisor, half);
+    // divisor * x is within a few divisors of SEG_MAX ** (n + half), so the error takes a wrapped product of about n segments.
+    power.shiftSegments_(half - precision);
+    int2048 error;
+    if (const int length = wrappedLength_(n + 2)) {
+      if (prepared != nullptr) {
+        error = mulSubWrapped_(power, x, *prepared, length);
+      } else {
+        PreparedMultiplier local(divisor);
+        error = mulSubWrapped_(power, x, local, length);
+      }
+    } else {
+      error = divisor;
+      error *= x;
+      error.signbit_ = true;
+      error += power;
+    }
+    // the lowest n - 2 segments of the error shift out below the last unit.
+    error.shiftSegments_(precision - half + 2 - n);
+    error *= x;
+    error.shiftSegments_(-(half + 2));
+    x.shiftSegments_(precision - half);
+    return x += error;
+  }
+  /// Divides numerator by denominator with a Newton reciprocal, both non-negative and denominator not null.
+  static DivisionResult_<int2048> divNewton_ (const int2048 &numerator, const int2048 &denominator) {
+    const int szNumerator = numerator.segments_.size();
+    const int szDenominator = denominator.segments_.size();
+    DivisionResult_<int2048> res;
+    PreparedMultiplier prepared(denominator);
+    res.quotient = reciprocal_(denominator, szNumerator - szDenominator, &prepared);
+    // as in reciprocal_, the lowest szDenominator - 2 segments of numerator do not affect the estimate.
+    int2048 leading = numerator;
+    leading.shiftSegments_(szDenominator > 2 ? 2 - szDenominator : 0);
+    res.quotient *= leading;
+    res.quotient.shiftSegments_(-szNumerator + (szDenominator > 2 ? szDenominator - 2 : 0));
+    // the remainder is within a few denominators, so it takes a wrapped product at the length of the last Newton step.
+    if (const int length = wrappedLength_(szDenominator + 2)) {
+      res.remainder = mulSubWrapped_(numerator, res.quotient, prepared, length);
+    } else {
+      res.remainder = res.quotient;
+      res.remainder *= denominator;
+      res.remainder.signbit_ = true;
+      res.remainder += numerator;
+    }
+    // the estimate is off by a few units at most.
+    while (res.remainder.signbit_ && !res.remainder.isNull_()) {
+      INT2048_COUNT_(divCorrections, 1);
+      res.quotient -= 1;
+      res.remainder += denominator;
+    }
+    res.remainder.signbit_ = false;
+    while (cmpValue_(res.remainder, denominator) >= 0) {
+      INT2048_COUNT_(divCorrections, 1);
+      res.quotient += 1;
+      res.remainder -= denominator;
+    }
+    return res;
+  }
+
+  /// Divides magnitudes with the fastest applicable algorithm; both operands must be non-negative.
+  static DivisionResult_<int2048> divModValue_ (const int2048 &numerator, const int2048 &denominator) {
+    if (cmpValue_(numerator, denominator) < 0) {
+      DivisionResult_<int2048> res;
+      res.remainder = numerator;
+      return res;
+    }
+    const int szNumerator = numerator.segments_.size();
+    const int szDenominator = denominator.segments_.size();
+    if (szDenominator < BZ_DIV_THRESHOLD || szNumerator - szDenominator < BZ_DIV_THRESHOLD) {
+      INT2048_COUNT_(divSchoolbook, 1);
+      return divModSchoolbook_(numerator, denominator);
+    }
+    if (szDenominator >= NEWTON_DIV_THRESHOLD && szNumerator <= 2 * szDenominator) {
+      INT2048_COUNT_(divNewton, 1);
+      return divNewton_(numerator, denominator);
+    }
+    INT2048_COUNT_(divBurnikelZiegler, 1);
+    return divBurnikelZiegler_(numerator, denominator);
+  }
+
  public:
+  /// Quotient and remainder of one division, as returned by divmod and tdivmod.
+  using DivModResult = DivisionResult_<int2048>;
+  /** Truncating division: the quotient rounds toward zero and the remainder takes the sign of the numerator,
+      like the built-in / and % on C++ integers. */
+  friend DivModResult tdivmod (int2048 numerator, int2048 denominator) {
+    assert(!denominator.isNull_());
+    const bool negativeNumerator = numerator.signbit_;
+    const bool negativeQuotient = numerator.signbit_ != denominator.signbit_;
+    numerator.signbit_ = denominator.signbit_ = false;
+    DivModResult res = divModValue_(numerator, denominator);
+    res.quotient.signbit_ = negativeQuotient && !res.quotient.isNull_();
+    res.remainder.signbit_ = negativeNumerator && !res.remainder.isNull_();
+    return res;
+  }
+  /** Floor division: the quotient rounds toward negative infinity and the remainder takes the sign of the denominator,
+      so numerator == quotient * denominator + remainder with 0 <= |remainder| < |denominator|, as in Python.
+      The operators /, %, /= and %= follow these semantics for both int2048 and machine integer operands. */
+  friend DivModResult divmod (int2048 numerator, const int2048 &denominator) {
+    DivModResult res = tdivmod(std::move(numerator), denominator);
+    if (!res.remainder.isNull_() && res.remainder.signbit_ != denominator.signbit_) {
+      res.quotient -= 1;
+      res.remainder += denominator;
+    }
+    return res;
+  }
   int2048 &operator/= (const int2048 &that) {
-    // https://treskal.com/s/masters-thesis.pdf, Algorithm 3.2. Retrieved 2021/11/12.
-    assert(!that.isNull_());
-    if (isNull_()) return *this;
-    assert(!signbit_ && !that.signbit_);
-    if (*this < that) return resetTo_(0);
-    const int szThis = segments_.size();
-    const int szThat = that.segments_.size();
-    if (that.segments_.back() < SEG_MAX / 2) {
-      TmpType mul = SEG_MAX / 2 / that.segments_.back() + 1;
-      int2048 newDividend = that;
-      *this *= mul;
-      newDividend *= mul;
-      return *this /= newDividend;
-    }
-    if (szThis == szThat) return resetTo_(1);
-    if (szThis == szThat + 1) return *this = std::move(divSubroutine_(*this, that).quotient);
-    auto shifted = rshift_(szThis - szThat - 1);
-    auto higher = divSubroutine_(shifted.quotient, that);
-    int2048 &lowerDivisor = shifted.remainder;
-    lowerDivisor.segments_.reserve(szThis - szThat - 1 + higher.remainder.segments_.size());
-    while (lowerDivisor.segments_.size() < szThis - szThat - 1) lowerDivisor.segments_.push_back(0);
-    for (const auto &seg : higher.remainder.segments_) lowerDivisor.segments_.push_back(seg);
-    lowerDivisor /= that;
-    *this = lowerDivisor;
-    if (higher.quotient.isNull_()) return *this;
-    segments_.reserve(szThis - szThat - 1 + higher.quotient.segments_.size());
-    while (segments_.size() < szThis - szThat - 1) segments_.push_back(0);
-    for (const auto &seg : higher.quotient.segments_) segments_.push_back(seg);
+    // moving from this would empty that when they alias.
+    if (this == &that) {
+      assert(!isNull_());
+      return resetTo_(1);
+    }
+    return assignKeepingResource_(std::move(divmod(std::move(*this), that).quotient));
+  }
+  int2048 &operator%= (const int2048 &that) {
+    if (this == &that) {
+      assert(!isNull_());
+      return resetTo_(0);
+    }
+    return assignKeepingResource_(std::move(divmod(std::move(*this), that).remainder));
+  }
+  friend int2048 operator/ (int2048 a, const int2048 &b) {
+    a /= b;
+    return a;
+  }
+  friend int2048 operator% (int2048 a, const int2048 &b) {
+    a %= b;
+    return a;
+  }
+
+  /* machine integer operands take a single pass over this and never build an int2048 for the operand.
+     Division and modulo round toward negative infinity, so the remainder takes the sign of the divisor. */
+  template <typename T, typename = EnableIfWord_<T>>
+  int2048 &operator*= (T factor) {
+    if (factor == 0 || isNull_()) return resetTo_(0);
+    if (isNegative_(factor)) signbit_ = !signbit_;
+    return mulWord_(magnitude_(factor));
+  }
+  template <typename T, typename = EnableIfWord_<T>>
+  int2048 &operator/= (T divisor) {
+    assert(divisor != 0);
+    const bool negative = signbit_ != isNegative_(divisor);
+    const std::uint64_t remainder = divSmall_(magnitude_(divisor));
+    if (negative && remainder != 0) incrementValue_();
+    signbit_ = negative && !isNull_();
     return *this;
   }
-  friend int2048 &operator/ (const int2048 &a, const int2048 &b) {
-    return *(new int2048(a)) /= b;
+  template <typename T, typename = EnableIfWord_<T>>
+  int2048 &operator%= (T divisor) {
+    assert(divisor != 0);
+    const std::uint64_t magnitude = magnitude_(divisor);
+    std::uint64_t remainder = modSmallSegments_(segments_.data(), segments_.size(), magnitude);
+    if (remainder != 0 && signbit_ != isNegative_(divisor)) remainder = magnitude - remainder;
+    setValue_(remainder, isNegative_(divisor));
+    return *this;
+  }
+  template <typename T, typename = EnableIfWord_<T>>
+  friend int2048 operator* (int2048 a, T b) {
+    a *= b;
+    return a;
+  }
+  template <typename T, typename = EnableIfWord_<T>>
+  friend int2048 operator* (T a, int2048 b) {
+    b *= a;
+    return b;
+  }
+  template <typename T, typename = EnableIfWord_<T>>
+  friend int2048 operator/ (int2048 a, T b) {
+    a /= b;
+    return a;
+  }
+  template <typename T, typename = EnableIfWord_<T>>
+  friend int2048 operator% (int2048 a, T b) {
+    a %= b;
+    return a;
   }
 
-  friend std::istream &operator>> (std::istream &stream, int2048 &number) {
-    std::string str;
-    stream >> str;
-    number.read(str);
-    return stream;
+  /// base ** exponent for a non-negative machine integer exponent; pow(0, 0) is 1.
+  template <typename T, typename = EnableIfWord_<T>>
+  friend int2048 pow (const int2048 &base, T exponent) {
+    assert(!isNegative_(exponent));
+    const std::uint64_t magnitude = magnitude_(exponent);
+    const std::uint32_t words[] = { static_cast<std::uint32_t>(magnitude), static_cast<std::uint32_t>(magnitude >> 32) };
+    return powWindow_(base, words, 2, 1, [] (int2048 &x, const int2048 &y) { x *= y; }, [] (int2048 &x) { x.square(); });
   }
-  friend std::ostream &operator<< (std::ostream &stream, const int2048 &number) {
-    if (number.signbit_ && (number.segments_.size() > 1 || number.segments_[0] > 0)) stream << '-';
-    bool firstSegment = true;
-    for (auto it = number.segments_.rbegin(); it != number.segments_.rend(); ++it) {
-      const auto &seg = *it;
-      if (firstSegment) {
-        firstSegment = false;
-        stream << seg;
+  /** Barrett reduction modulo a fixed positive m, for repeated modular arithmetic such as powmod.
+      Defined after int2048, since it keeps int2048 members. */
+  class Modulus;
+  /// base ** exponent mod modulus in [0, modulus), for a non-negative exponent and a positive modulus.
+  friend int2048 powmod (const int2048 &base, const int2048 &exponent, const int2048 &modulus);
+
+ private:
+  /// Little-endian 32-bit words of the non-negative x.
+  static std::vector<std::uint32_t> words32_ (int2048 x) {
+    std::vector<std::uint32_t> words;
+    while (!x.isNull_()) words.push_back(x.divSmall_(1ULL << 32));
+    return words;
+  }
+  /** Raises base to the exponent with little-endian 32-bit words, scanning it left to right with a sliding window.
+      mul(x, y) sets x to x * y and sqr(x) squares x in place; one is the result for a zero exponent.
+      See: Handbook of Applied Cryptography, Algorithm 14.85. */
+  template <typename Mul, typename Sqr>
+  static int2048 powWindow_ (const int2048 &base, const std::uint32_t *words, int nWords, const int2048 &one, const Mul &mul, const Sqr &sqr) {
+    const auto bit = [words] (int i) { return words[i / 32] >> (i % 32) & 1; };
+    int bits = nWords * 32;
+    while (bits > 0 && !bit(bits - 1)) --bits;
+    if (bits == 0) return one;
+    // wider windows save multiplications on long exponents but cost more precomputed powers.
+    const int window = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 7 ? 2 : 1;
+    // odd[i] is base ** (2 i + 1).
+    std::vector<int2048> odd(1 << (window - 1), base);
+    if (window > 1) {
+      int2048 baseSquared = base;
+      sqr(baseSquared);
+      for (std::size_t i = 1; i < odd.size(); ++i) {
+        odd[i] = odd[i - 1];
+        mul(odd[i], baseSquared);
+      }
+    }
+    int2048 result;
+    bool started = false;
+    for (int i = bits - 1; i >= 0;) {
+      if (!bit(i)) {
+        sqr(result);
+        --i;
+        continue;
+      }
+      // the longest window of at most window bits from bit i down that ends in a set bit.
+      int low = i - window + 1 > 0 ? i - window + 1 : 0;
+      while (!bit(low)) ++low;
+      int value = 0;
+      for (int j = i; j >= low; --j) value = value * 2 + bit(j);
+      if (started) {
+        for (int j = i; j >= low; --j) sqr(result);
+        mul(result, odd[value / 2]);
+      } else {
+        result = odd[value / 2];
+        started = true;
+      }
+      i = low - 1;
+    }
+    return result;
+  }
+
+  template <typename T>
+  struct RootResult_ {
+    T root;
+    T remainder;
+  };
+  /** floor(a ** (1 / k)) for a > 0 and k >= 2, by Newton iteration from above: x -> ((k - 1) x + a / x ** (k - 1)) / k.
+      The start comes from the root of the leading half of a, so each level doubles the precision and one or two steps
+      at full size finish the job; the innermost level starts from a floating-point estimate of the leading segments.
+      See: Richard P. Brent and Paul Zimmermann, Modern Computer Arithmetic, Algorithm 1.14. */
+  static int2048 rootValue_ (const int2048 &a, unsigned k) {
+    const int szA = a.segments_.size();
+    // segments dropped from the root at this level: half of the about szA / k it has.
+    const int dropped = (szA - 1) / k / 2;
+    int2048 x;
+    if (dropped > 0) {
+      int2048 leading = a;
+      leading.shiftSegments_(-static_cast<int>(k) * dropped);
+      // the root of a is below that of (leading + 1) * SEG_MAX ** (k * dropped), so x starts above it.
+      x = rootValue_(leading, k);
+      x.incrementValue_();
+      x.shiftSegments_(dropped);
+    } else {
+      double mantissa = 0;
+      const int szLeading = szA < 3 ? szA : 3;
+      for (int i = 1; i <= szLeading; ++i) mantissa = mantissa * SEG_MAX + a.segments_[szA - i];
+      const double logRoot = (std::log10(mantissa) + (szA - szLeading) * SEG_LENGTH) / k;
+      // the root has at most 2 * SEG_LENGTH digits here; the estimate is padded to stay above it.
+      const int exponent = logRoot > 17 ? static_cast<int>(logRoot) - 16 : 0;
+      x = static_cast<long long>(std::pow(10.0, logRoot - exponent) * (1 + 1e-9)) + 2;
+      if (exponent > 0) x *= pow(int2048(10), exponent);
+    }
+    while (true) {
+      int2048 next = divmod(a, k == 2 ? x : pow(x, k - 1)).quotient;
+      next += x * (k - 1);
+      next /= k;
+      if (next >= x) return x;
+      x = std::move(next);
+      // x stays at or above the root, and one step from the estimate usually lands on it or one above;
+      // checking that with powers is cheaper than the division of another step.
+      if (pow(x, k) <= a) return x;
+      x -= 1;
+      if (pow(x, k) <= a) return x;
+    }
+  }
+
+ public:
+  /// Root and remainder of sqrtrem and rootrem: a == root ** k + remainder.
+  using RootResult = RootResult_<int2048>;
+  /** The integer k-th root of a, rounded toward zero, and a - root ** k; k >= 1, and a >= 0 unless k is odd.
+      For negative a the root and remainder are negative. */
+  friend RootResult rootrem (const int2048 &a, unsigned k) {
+    assert(k >= 1 && (k % 2 == 1 || !a.signbit_ || a.isNull_()));
+    RootResult res;
+    if (a.isNull_() || k == 1) {
+      res.root = a;
+      return res;
+    }
+    int2048 magnitude = a;
+    magnitude.signbit_ = false;
+    res.root = rootValue_(magnitude, k);
+    res.root.signbit_ = a.signbit_;
+    res.remainder = a;
+    res.remainder -= pow(res.root, k);
+    return res;
+  }
+  friend RootResult sqrtrem (const int2048 &a) {
+    return rootrem(a, 2);
+  }
+  /// The integer k-th root of a, as in rootrem.
+  friend int2048 iroot (const int2048 &a, unsigned k) {
+    assert(k >= 1 && (k % 2 == 1 || !a.signbit_ || a.isNull_()));
+    if (a.isNull_() || k == 1) return a;
+    int2048 magnitude = a;
+    magnitude.signbit_ = false;
+    int2048 root = rootValue_(magnitude, k);
+    root.signbit_ = a.signbit_;
+    return root;
+  }
+  /// floor(sqrt(a)) for a >= 0.
+  friend int2048 isqrt (const int2048 &a) {
+    return iroot(a, 2);
+  }
+
+ private:
+  template <typename T>
+  struct GcdextResult_ {
+    T gcd;
+    T s;
+    T t;
+  };
+  /** Cofactors of a run of Euclidean steps: (a, b) before the steps equals matrix * (a, b) after them.
+      det is the determinant, 1 or -1. */
+  template <typename T>
+  struct GcdMatrix_ {
+    T m00 = 1, m01 = 0, m10 = 0, m11 = 1;
+    int det = 1;
+  };
+  /// Digits of the non-negative x.
+  static int digits_ (const int2048 &x) {
+    return segDigits_(x.segments_.back()) + (x.segments_.size() - 1) * SEG_LENGTH;
+  }
+  /// floor(x / 10 ** shift) for a non-negative x for which it has at most 18 digits.
+  static std::int64_t leadingDigits_ (const int2048 &x, int shift) {
+    const int szX = x.segments_.size();
+    const int low = shift / SEG_LENGTH;
+    WideType value = 0;
+    for (int i = szX - 1; i >= low; --i) value = value * SEG_MAX + x.segments_[i];
+    return static_cast<std::int64_t>(value / EXP10[shift % SEG_LENGTH]);
+  }
+  /// Sets (x, y) to (p x - q y, s y - r x) over n segments in place; both results must be non-negative.
+  static void combineSegments_ (SegType *x, SegType *y, int n, std::int64_t p, std::int64_t q, std::int64_t r, std::int64_t s) {
+    const TmpType base = SEG_MAX;
+    TmpType carryX = 0, carryY = 0;
+    for (int i = 0; i < n; ++i) {
+      const TmpType xi = x[i], yi = y[i];
+      TmpType valueX = p * xi - q * yi + carryX, valueY = s * yi - r * xi + carryY;
+      carryX = valueX / base;
+      valueX %= base;
+      if (valueX < 0) valueX += base, --carryX;
+      carryY = valueY / base;
+      valueY %= base;
+      if (valueY < 0) valueY += base, --carryY;
+      x[i] = valueX;
+      y[i] = valueY;
+    }
+    assert(carryX == 0 && carryY == 0);
+  }
+  /// matrix = matrix * [[q, 1], [1, 0]], following the step (a, b) -> (b, a - q b).
+  static void mulQuotient_ (GcdMatrix_<int2048> &matrix, const int2048 &q) {
+    int2048 next = matrix.m00 * q;
+    next += matrix.m01;
+    matrix.m01 = std::move(matrix.m00);
+    matrix.m00 = std::move(next);
+    next = matrix.m10 * q;
+    next += matrix.m11;
+    matrix.m11 = std::move(matrix.m10);
+    matrix.m10 = std::move(next);
+    matrix.det = -matrix.det;
+  }
+  /// matrix = matrix * that.
+  static void mulMatrix_ (GcdMatrix_<int2048> &matrix, const GcdMatrix_<int2048> &that) {
+    int2048 m00 = matrix.m00 * that.m00 + matrix.m01 * that.m10;
+    int2048 m01 = matrix.m00 * that.m01 + matrix.m01 * that.m11;
+    int2048 m10 = matrix.m10 * that.m00 + matrix.m11 * that.m10;
+    matrix.m11 = matrix.m10 * that.m01 + matrix.m11 * that.m11;
+    matrix.m00 = std::move(m00);
+    matrix.m01 = std::move(m01);
+    matrix.m10 = std::move(m10);
+    matrix.det *= that.det;
+  }
+  /// (x, y) = (p x + q y, r x + s y) for non-negative single-word p, q, r and s.
+  static void mulCofactors_ (int2048 &x, int2048 &y, std::int64_t p, std::int64_t q, std::int64_t r, std::int64_t s) {
+    if (x.signbit_ != y.signbit_ && !x.isNull_() && !y.isNull_()) {
+      int2048 nextX = x * p + y * q;
+      y = x * r + y * s;
+      x = std::move(nextX);
+      return;
+    }
+    // with equal signs this is a sum of magnitudes, which combineSegments_ forms in one pass.
+    const bool negative = x.signbit_ || y.signbit_;
+    const int n = std::max(x.segments_.size(), y.segments_.size()) + 1;
+    x.segments_.resize(n);
+    y.segments_.resize(n);
+    combineSegments_(x.segments_.data(), y.segments_.data(), n, p, -q, -r, s);
+    x.normalize_();
+    y.normalize_();
+    x.signbit_ = negative && !x.isNull_();
+    y.signbit_ = negative && !y.isNull_();
+  }
+  /// One Euclidean step on a >= b > 0: (a, b) -> (b, a mod b).
+  static void divisionStep_ (int2048 &a, int2048 &b, GcdMatrix_<int2048> *matrix) {
+    INT2048_COUNT_(gcdDivisionSteps, 1);
+    DivisionResult_<int2048> res = divModValue_(a, b);
+    if (matrix) mulQuotient_(*matrix, res.quotient);
+    a = std::move(b);
+    b = std::move(res.remainder);
+  }
+  /** Runs as many Euclidean steps on a >= b > 0 as the leading 18 digits of a, and the digits of b at the same places,
+      determine, and applies them to a and b in one pass with single-word cofactors.
+      Returns false, changing nothing, if a has at most 18 digits or not even one step was certain.
+      The exit condition is Jebelean's, as in CPython's _PyLong_GCD (Objects/longobject.c); it also keeps the cofactors
+      below the square root of the leading digits, so they fit a word. */
+  static bool lehmerStep_ (int2048 &a, int2048 &b, GcdMatrix_<int2048> *matrix) {
+    const int shift = digits_(a) - 18;
+    if (shift <= 0) return false;
+    std::int64_t x = leadingDigits_(a, shift), y = leadingDigits_(b, shift);
+    std::int64_t A = 1, B = 0, C = 0, D = 1;
+    int k = 0;
+    for (;; ++k) {
+      if (y == C) break;
+      const std::int64_t q = (x + (A - 1)) / (y - C);
+      const std::int64_t s = B + q * D;
+      const std::int64_t t = x - q * y;
+      if (s > t) break;
+      x = y;
+      y = t;
+      const std::int64_t u = A + q * C;
+      A = D;
+      B = C;
+      C = s;
+      D = u;
+    }
+    if (k == 0) return false;
+    INT2048_COUNT_(gcdLehmerSteps, 1);
+    // (a, b) becomes (A a - B b, D b - C a) after an even number of steps, and (A b - B a, D a - C b) after an odd one.
+    const int szA = a.segments_.size();
+    b.segments_.resize(szA);
+    if (k % 2 == 0) {
+      combineSegments_(a.segments_.data(), b.segments_.data(), szA, A, B, C, D);
+    } else {
+      combineSegments_(b.segments_.data(), a.segments_.data(), szA, A, B, C, D);
+      std::swap(a, b);
+    }
+    a.normalize_();
+    b.normalize_();
+    if (matrix) {
+      // the steps map (a, b) by [[A, -B], [-C, D]] or [[-B, A], [D, -C]], whose inverses are [[D, B], [C, A]] and [[C, A], [D, B]].
+      if (k % 2 == 0) {
+        mulCofactors_(matrix->m00, matrix->m01, D, C, B, A);
+        mulCofactors_(matrix->m10, matrix->m11, D, C, B, A);
       } else {
-        char str[SEG_LENGTH + 1];
-        str[SEG_LENGTH] = '\0';
-        SegType current = seg;
-        for (int i = SEG_LENGTH - 1; i >= 0; --i) {
-          str[i] = (current % 10) + '0';
-          current /= 10;
+        mulCofactors_(matrix->m00, matrix->m01, C, D, A, B);
+        mulCofactors_(matrix->m10, matrix->m11, C, D, A, B);
+        matrix->det = -matrix->det;
+      }
+    }
+    return true;
+  }
+  /** (a, b) = matrix ** -1 (a, b), made non-negative with a >= b again; matrix is adjusted to keep describing the steps.
+      The matrix may come from the leading segments alone and be off by a step near its end, which only costs a sign or an
+      order here: with determinant +-1 it never changes the gcd. */
+  static void applyInverse_ (GcdMatrix_<int2048> &matrix, int2048 &a, int2048 &b) {
+    int2048 nextA = matrix.m11 * a - matrix.m01 * b;
+    int2048 nextB = matrix.m00 * b - matrix.m10 * a;
+    if (matrix.det < 0) {
+      nextA.signbit_ = !nextA.signbit_ && !nextA.isNull_();
+      nextB.signbit_ = !nextB.signbit_ && !nextB.isNull_();
+    }
+    a = std::move(nextA);
+    b = std::move(nextB);
+    if (a.signbit_) {
+      a.signbit_ = false;
+      matrix.m00.signbit_ = !matrix.m00.signbit_ && !matrix.m00.isNull_();
+      matrix.m10.signbit_ = !matrix.m10.signbit_ && !matrix.m10.isNull_();
+      matrix.det = -matrix.det;
+    }
+    if (b.signbit_) {
+      b.signbit_ = false;
+      matrix.m01.signbit_ = !matrix.m01.signbit_ && !matrix.m01.isNull_();
+      matrix.m11.signbit_ = !matrix.m11.signbit_ && !matrix.m11.isNull_();
+      matrix.det = -matrix.det;
+    }
+    if (cmpValue_(a, b) < 0) {
+      std::swap(a, b);
+      std::swap(matrix.m00, matrix.m01);
+      std::swap(matrix.m10, matrix.m11);
+      matrix.det = -matrix.det;
+    }
+  }
+  /** Euclidean steps on a >= b >= 0 until b has at most n / 2 + 1 segments, where a has n; matrix, if given, receives
+      their cofactors. Large inputs first reduce their leading half recursively, which takes a to about 3n / 4 segments,
+      then the leading part of what is left, so the cofactors are built by fast multiplication.
+      See: Niels Möller, On Schönhage's algorithm and subquadratic integer gcd computation, Math. Comp. 77 (2008). */
+  static void halfGcd_ (int2048 &a, int2048 &b, GcdMatrix_<int2048> *matrix) {
+    INT2048_DEPTH_();
+    INT2048_COUNT_(gcdHalfGcd, 1);
+    if (matrix) *matrix = GcdMatrix_<int2048>();
+    const int n = a.segments_.size();
+    const int target = n / 2 + 1;
+    if (n >= HGCD_THRESHOLD && static_cast<int>(b.segments_.size()) > target) {
+      int2048 leadingA = a, leadingB = b;
+      leadingA.shiftSegments_(-(n / 2));
+      leadingB.shiftSegments_(-(n / 2));
+      GcdMatrix_<int2048> steps;
+      halfGcd_(leadingA, leadingB, &steps);
+      applyInverse_(steps, a, b);
+      if (matrix) *matrix = std::move(steps);
+      if (static_cast<int>(b.segments_.size()) > target) divisionStep_(a, b, matrix);
+      const int shift = 2 * target - static_cast<int>(a.segments_.size());
+      if (static_cast<int>(b.segments_.size()) > target && shift > 0) {
+        leadingA = a;
+        leadingB = b;
+        leadingA.shiftSegments_(-shift);
+        leadingB.shiftSegments_(-shift);
+        halfGcd_(leadingA, leadingB, &steps);
+        applyInverse_(steps, a, b);
+        if (matrix) mulMatrix_(*matrix, steps);
+      }
+    }
+    while (static_cast<int>(b.segments_.size()) > target) {
+      if (!lehmerStep_(a, b, matrix)) divisionStep_(a, b, matrix);
+    }
+  }
+  /// gcd of a, b >= 0; matrix, if given, receives the cofactors of all the steps, with (a, b) == matrix * (gcd, 0).
+  static int2048 gcdValue_ (int2048 a, int2048 b, GcdMatrix_<int2048> *matrix) {
+    if (cmpValue_(a, b) < 0) {
+      std::swap(a, b);
+      if (matrix) {
+        std::swap(matrix->m00, matrix->m01);
+        std::swap(matrix->m10, matrix->m11);
+        matrix->det = -matrix->det;
+      }
+    }
+    while (!b.isNull_()) {
+      const int szB = b.segments_.size();
+      if (szB >= HGCD_THRESHOLD) {
+        if (matrix) {
+          GcdMatrix_<int2048> steps;
+          halfGcd_(a, b, &steps);
+          mulMatrix_(*matrix, steps);
+        } else {
+          halfGcd_(a, b, nullptr);
+        }
+        // halfGcd_ does nothing when b is already much shorter than a.
+        if (static_cast<int>(b.segments_.size()) < szB) continue;
+      } else if (!matrix && digits_(a) <= 18) {
+        std::uint64_t x = leadingDigits_(a, 0), y = leadingDigits_(b, 0);
+        while (y != 0) {
+          const std::uint64_t t = x % y;
+          x = y;
+          y = t;
+        }
+        return x;
+      }
+      if (!lehmerStep_(a, b, matrix)) divisionStep_(a, b, matrix);
+    }
+    return a;
+  }
+
+ public:
+  /// gcd and the Bezout coefficients of gcdext: a * s + b * t == gcd.
+  using GcdextResult = GcdextResult_<int2048>;
+  /// Greatest common divisor of |a| and |b|; gcd(0, 0) is 0.
+  friend int2048 gcd (const int2048 &a, const int2048 &b) {
+    int2048 magnitudeA = a, magnitudeB = b;
+    magnitudeA.signbit_ = magnitudeB.signbit_ = false;
+    return gcdValue_(std::move(magnitudeA), std::move(magnitudeB), nullptr);
+  }
+  /// Least common multiple of |a| and |b|; 0 if either is 0.
+  friend int2048 lcm (const int2048 &a, const int2048 &b) {
+    if (a.isNull_() || b.isNull_()) return 0;
+    int2048 res = a;
+    res.signbit_ = false;
+    res /= gcd(a, b);
+    res *= b;
+    res.signbit_ = false;
+    return res;
+  }
+  /** gcd(a, b) with s and t such that a * s + b * t == gcd. Unless |a| == |b| or one is 0, |s| <= |b| / (2 gcd) and
+      |t| <= |a| / (2 gcd), as with the extended Euclidean algorithm; gcdext(0, 0) gives all zeros. */
+  friend GcdextResult gcdext (const int2048 &a, const int2048 &b) {
+    GcdextResult res;
+    int2048 magnitudeA = a, magnitudeB = b;
+    magnitudeA.signbit_ = magnitudeB.signbit_ = false;
+    GcdMatrix_<int2048> matrix;
+    res.gcd = gcdValue_(magnitudeA, magnitudeB, &matrix);
+    if (res.gcd.isNull_()) return res;
+    // (gcd, 0) == matrix ** -1 (|a|, |b|), whose first row is det (m11, -m01).
+    res.s = std::move(matrix.m11);
+    if (matrix.det < 0) res.s.signbit_ = !res.s.signbit_ && !res.s.isNull_();
+    if (!magnitudeB.isNull_()) {
+      // other solutions differ by multiples of |b| / gcd in s; take the one closest to 0.
+      const int2048 period = magnitudeB / res.gcd;
+      res.s %= period;
+      if (res.s + res.s > period) res.s -= period;
+      res.t = (res.gcd - magnitudeA * res.s) / magnitudeB;
+    } else {
+      res.t = 0;
+    }
+    if (a.signbit_) res.s.signbit_ = !res.s.signbit_ && !res.s.isNull_();
+    if (b.signbit_) res.t.signbit_ = !res.t.signbit_ && !res.t.isNull_();
+    return res;
+  }
+
+  /** Product of the factors in [first, last), each an int2048 or a machine integer; 1 if the range is empty.
+      Factors are packed into machine words first, and the words multiplied in a balanced tree, so the large products
+      meet operands of similar size and the fast multiplication tiers. Large products follow the parallel policy. */
+  template <typename Iterator>
+  friend int2048 product (Iterator first, Iterator last);
+  /// n!, as a product tree over 1, ..., n.
+  friend int2048 factorial (unsigned n);
+  /// n choose k, or 0 if k > n.
+  friend int2048 binomial (unsigned n, unsigned k);
+
+ private:
+  /// Product trees spread their leading subtrees over the threads of the parallel policy from this many segments on.
+  static constexpr int PARALLEL_PRODUCT_SEGMENTS = 1 << 13;
+  /// binomial factors n choose k over the primes up to n for n up to this, and divides by k! above it.
+  static constexpr unsigned BINOMIAL_SIEVE_LIMIT = 1U << 26;
+  /** binomial also divides by k! while k * log2(n) * this < n: the falling product of k words then costs less than
+      sieving up to n, which takes milliseconds from n = 10 ** 6 on whatever k is. */
+  static constexpr std::uint64_t BINOMIAL_SIEVE_RATIO = 32;
+  /// Multiplies the non-zero magnitude into word, first moving word to a new leaf if the product would overflow.
+  static void packFactor_ (std::vector<int2048> &leaves, std::uint64_t &word, std::uint64_t magnitude) {
+    std::uint64_t next;
+    if (!__builtin_mul_overflow(word, magnitude, &next)) {
+      word = next;
+      return;
+    }
+    leaves.emplace_back();
+    leaves.back().setValue_(word, false);
+    word = magnitude;
+  }
+  /// Product of the non-negative factors[0, count), count >= 1, split where the halves have about equal segments.
+  static int2048 productTree_ (int2048 *factors, int count) {
+    if (count == 1) return std::move(factors[0]);
+    std::size_t total = 0;
+    for (int i = 0; i < count; ++i) total += factors[i].segments_.size();
+    int middle = 1;
+    for (std::size_t left = factors[0].segments_.size(); middle < count - 1 && 2 * (left + factors[middle].segments_.size()) <= total; ++middle) {
+      left += factors[middle].segments_.size();
+    }
+    int2048 res = productTree_(factors, middle);
+    res *= productTree_(factors + middle, count - middle);
+    return res;
+  }
+  /** Product of the non-negative leaves, which are consumed. Large products under a parallel policy split the leaves into
+      one run of about equal segments per thread, multiply the runs concurrently, then multiply the partial products on
+      this thread, where the final multiplications spread their transforms instead. */
+  static int2048 productValue_ (std::vector<int2048> &leaves) {
+    const int count = leaves.size();
+    const int threads = parallelPolicy_().threads;
+    std::size_t total = 0;
+    for (const int2048 &leaf : leaves) total += leaf.segments_.size();
+    if (threads <= 1 || count < 2 * threads || total < static_cast<std::size_t>(PARALLEL_PRODUCT_SEGMENTS)) return productTree_(leaves.data(), count);
+    std::vector<int> bounds(threads + 1, count);
+    bounds[0] = 0;
+    std::size_t prefix = 0;
+    for (int i = 0, run = 1; i < count && run < threads; ++i) {
+      prefix += leaves[i].segments_.size();
+      if (prefix * threads >= total * run) bounds[run++] = i + 1;
+    }
+    std::vector<int2048> partials(threads);
+    runTasks_(threads, true, [&] (int run) {
+      if (bounds[run] < bounds[run + 1]) partials[run] = productTree_(leaves.data() + bounds[run], bounds[run + 1] - bounds[run]);
+      else partials[run] = 1;
+    });
+    return productTree_(partials.data(), threads);
+  }
+
+ public:
+  /// Operations evaluate() applies pairwise, each like the operator or function of the same name.
+  enum class BatchOp { ADD, MINUS, MUL, DIV, MOD };
+  /** Sets results[i] to a[i] op b[i] for each i in [0, count); DIV and MOD floor like / and %.
+      results[i] may be a[i] or b[i] itself, and keeps its memory resource. Batches with enough work spread over the threads of
+      the parallel policy, each worker with its own scratch arena, so an executor with long-lived threads keeps the arenas
+      warm from batch to batch. Pairs are scheduled largest first: a worker drains its own share, then steals from the others. */
+  friend void evaluate (BatchOp op, const int2048 *a, const int2048 *b, int2048 *results, std::size_t count) {
+    std::vector<std::uint64_t> work(count);
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) total += work[i] = batchWork_(op, a[i], b[i]);
+    const int threads = parallelPolicy_().threads;
+    if (threads <= 1 || count < 2 || total < PARALLEL_BATCH_WORK) {
+      for (std::size_t i = 0; i < count; ++i) evaluateOne_(op, a[i], b[i], results[i]);
+      return;
+    }
+    std::vector<std::size_t> order(count);
+    for (std::size_t i = 0; i < count; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&] (std::size_t x, std::size_t y) { return work[x] > work[y]; });
+    // the pairs are dealt round-robin in that order, so queue w holds order[w], order[w + szPool], ...
+    const int szPool = count < static_cast<std::size_t>(threads) ? count : threads;
+    std::vector<BatchQueue_> queues(szPool);
+    runTasks_(szPool, true, [&] (int worker) {
+      for (int k = 0; k < szPool; ++k) {
+        const int victim = (worker + k) % szPool;
+        const std::size_t length = (count - victim + szPool - 1) / szPool;
+        for (std::size_t i = queues[victim].next++; i < length; i = queues[victim].next++) {
+          const std::size_t index = order[victim + i * szPool];
+          evaluateOne_(op, a[index], b[index], results[index]);
         }
-        stream << str;
       }
+    });
+  }
+
+ private:
+  /// Batches of at least this much work, in estimated segment operations, spread over the threads of the parallel policy.
+  static constexpr std::uint64_t PARALLEL_BATCH_WORK = 1 << 16;
+  /// Cursor into the share of one worker; owner and thieves alike take the next pair through it.
+  struct alignas(64) BatchQueue_ {
+    std::atomic<std::size_t> next{0};
+  };
+  /// Rough segment operations of a op b, by which batches are split and ordered.
+  static std::uint64_t batchWork_ (BatchOp op, const int2048 &a, const int2048 &b) {
+    const std::uint64_t szA = a.segments_.size(), szB = b.segments_.size();
+    switch (op) {
+    case BatchOp::MUL:
+      return szA * szB;
+    case BatchOp::DIV:
+    case BatchOp::MOD:
+      return szA > szB ? (szA - szB + 1) * szB : szA;
+    default:
+      return szA > szB ? szA : szB;
+    }
+  }
+  static void applyBatchOp_ (BatchOp op, int2048 &a, const int2048 &b) {
+    switch (op) {
+    case BatchOp::ADD:
+      a += b;
+      break;
+    case BatchOp::MINUS:
+      a -= b;
+      break;
+    case BatchOp::MUL:
+      a *= b;
+      break;
+    case BatchOp::DIV:
+      a /= b;
+      break;
+    case BatchOp::MOD:
+      a %= b;
+      break;
+    }
+  }
+  /// Computes into res, whose buffer and resource are reused unless it aliases b alone.
+  static void evaluateOne_ (BatchOp op, const int2048 &a, const int2048 &b, int2048 &res) {
+    if (&res == &b && &res != &a) {
+      int2048 value(a);
+      applyBatchOp_(op, value, b);
+      res.assignKeepingResource_(std::move(value));
+      return;
     }
+    if (&res != &a) res = a;
+    applyBatchOp_(op, res, b);
+  }
+
+ public:
+  /// Number of characters to_chars writes for this.
+  std::size_t charsLength () const {
+    return (signbit_ && !isNull_() ? 1 : 0) + segDigits_(segments_.back()) + (segments_.size() - 1) * SEG_LENGTH;
+  }
+  /** Writes the decimal representation of value into [first, last) like std::to_chars.
+      Returns one past the last character written, or last with std::errc::value_too_large if it does not fit. */
+  friend std::to_chars_result to_chars (char *first, char *last, const int2048 &value) {
+    const std::size_t length = value.charsLength();
+    if (static_cast<std::size_t>(last - first) < length) return { last, std::errc::value_too_large };
+    if (value.signbit_ && !value.isNull_()) *first++ = '-';
+    const int size = value.segments_.size();
+    const int topDigits = segDigits_(value.segments_[size - 1]);
+    writeDigits_(first, value.segments_[size - 1], topDigits);
+    first += topDigits;
+    for (int i = size - 2; i >= 0; --i, first += SEG_LENGTH) writeDigits_(first, value.segments_[i], SEG_LENGTH);
+    return { first, std::errc() };
+  }
+  /** Parses an optional '-' followed by decimal digits from [first, last) into value like std::from_chars, stopping at the first non-digit.
+      Returns std::errc::invalid_argument and leaves value untouched if there are no digits. */
+  friend std::from_chars_result from_chars (const char *first, const char *last, int2048 &value) {
+    const bool negative = first != last && *first == '-';
+    const char *begin = negative ? first + 1 : first;
+    const char *end = begin;
+    while (end != last && *end >= '0' && *end <= '9') ++end;
+    if (end == begin) return { first, std::errc::invalid_argument };
+    value.readDigits_(begin, end - begin);
+    value.signbit_ = negative && !value.isNull_();
+    return { end, std::errc() };
+  }
+
+  friend std::istream &operator>> (std::istream &stream, int2048 &number) {
+    // kept across calls, so reading many numbers does not reallocate.
+    static thread_local std::string token;
+    if (stream >> token) number.read(token);
     return stream;
   }
+  friend std::ostream &operator<< (std::ostream &stream, const int2048 &number) {
+    const std::size_t length = number.charsLength();
+    char local[64];
+    if (length <= sizeof(local)) {
+      to_chars(local, local + length, number);
+      return stream.write(local, length);
+    }
+    std::string buffer(length, '\0');
+    to_chars(&buffer[0], &buffer[0] + length, number);
+    return stream.write(buffer.data(), length);
+  }
+
+ private:
+  /// "00" to "99", so digits are converted two at a time.
+  static constexpr char DIGIT_PAIRS[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+  /// Number of decimal digits of seg, at least 1.
+  static int segDigits_ (SegType seg) {
+    int digits = 1;
+    while (digits < SEG_LENGTH && seg >= EXP10[digits]) ++digits;
+    return digits;
+  }
+  /// Writes the lowest length digits of seg, zero-padded, into [out, out + length).
+  static void writeDigits_ (char *out, SegType seg, int length) {
+    while (length >= 2) {
+      length -= 2;
+      std::memcpy(out + length, DIGIT_PAIRS + 2 * (seg % 100), 2);
+      seg /= 100;
+    }
+    if (length == 1) out[0] = '0' + seg % 10;
+  }
+  /// Parses exactly 8 digits at once.
+  static std::uint64_t parseEightDigits_ (const char *in) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Lemire, Quickly parsing eight digits: combine digit pairs, then pairs of pairs, then the two halves, all in one register.
+    std::uint64_t chunk;
+    std::memcpy(&chunk, in, 8);
+    chunk -= 0x3030303030303030ULL;
+    chunk = chunk * 10 + (chunk >> 8);
+    return ((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)) + ((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))) >> 32;
+#else
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value = value * 10 + (in[i] - '0');
+    return value;
+#endif
+  }
+  /// Parses length (at most 19) digits starting at in.
+  static std::uint64_t parseDigits_ (const char *in, int length) {
+    std::uint64_t value = 0;
+    for (; length >= 8; in += 8, length -= 8) value = value * 100000000 + parseEightDigits_(in);
+    for (; length > 0; ++in, --length) value = value * 10 + (*in - '0');
+    return value;
+  }
+  /// Sets the absolute value of this to the length (at least 1) decimal digits starting at digits.
+  void readDigits_ (const char *digits, std::size_t length) {
+    while (length > 1 && *digits == '0') ++digits, --length;
+    const int size = (length + SEG_LENGTH - 1) / SEG_LENGTH;
+    segments_.resize(size);
+    const char *end = digits + length;
+    for (int i = 0; i < size - 1; ++i, end -= SEG_LENGTH) segments_[i] = parseDigits_(end - SEG_LENGTH, SEG_LENGTH);
+    segments_[size - 1] = parseDigits_(digits, end - digits);
+  }
 
  private:
   /// -1 if lhs < rhs, 0 if lhs = rhs, 1 if lhs > rhs; ignores sign bit. Requires lhs and rhs be not null.
@@ -404,6 +2625,128 @@ class int2048 {
   inline friend bool operator<= (const int2048 &lhs, const int2048 &rhs) { return cmp_(lhs, rhs) <= 0; }
   inline friend bool operator>= (const int2048 &lhs, const int2048 &rhs) { return cmp_(lhs, rhs) >= 0; }
 };
+
+/* Barrett reduction in base SEG_MAX: with k the segment count of m and mu = SEG_MAX ** (2 k) / m precomputed,
+   x in [0, SEG_MAX ** (2 k)) reduces with two multiplications and at most two subtractions instead of a long division.
+   See: Handbook of Applied Cryptography, Algorithm 14.42. Montgomery reduction would need m coprime to the base 10 ** 9;
+   Barrett takes any modulus. */
+class int2048::Modulus {
+ public:
+  explicit Modulus (const int2048 &modulus) : modulus_(modulus), size_(modulus.segments_.size()) {
+    assert(!modulus_.signbit_ && !modulus_.isNull_());
+    int2048 power = 1;
+    power.shiftSegments_(2 * size_);
+    mu_ = divmod(std::move(power), modulus_).quotient;
+  }
+  const int2048 &modulus () const {
+    return modulus_;
+  }
+  /// x mod m in [0, m), rounding the quotient toward negative infinity for negative x.
+  int2048 reduce (const int2048 &x) const {
+    if (x.signbit_ && !x.isNull_()) return divmod(x, modulus_).remainder;
+    if (static_cast<int>(x.segments_.size()) > 2 * size_) return divmod(x, modulus_).remainder;
+    if (cmpValue_(x, modulus_) < 0) return x;
+    int2048 quotient = x;
+    quotient.shiftSegments_(1 - size_);
+    quotient *= mu_;
+    quotient.shiftSegments_(-size_ - 1);
+    // quotient is at most two short of x / m.
+    quotient *= modulus_;
+    int2048 remainder = x;
+    remainder.subValue_(quotient);
+    while (cmpValue_(remainder, modulus_) >= 0) remainder.subValue_(modulus_);
+    return remainder;
+  }
+  /// a * b mod m for a and b in [0, m).
+  int2048 mul (const int2048 &a, const int2048 &b) const {
+    return reduce(a * b);
+  }
+  /// base ** exponent mod m for a non-negative exponent.
+  int2048 pow (const int2048 &base, const int2048 &exponent) const {
+    assert(!exponent.signbit_ || exponent.isNull_());
+    const std::vector<std::uint32_t> words = words32_(exponent);
+    return powWindow_(reduce(base), words.data(), words.size(), reduce(1),
+                      [this] (int2048 &x, const int2048 &y) { x = mul(x, y); },
+                      [this] (int2048 &x) { x = reduce(sqr(std::move(x))); });
+  }
+
+ private:
+  int2048 modulus_;
+  int size_;
+  int2048 mu_;
+};
+
+inline int2048 powmod (const int2048 &base, const int2048 &exponent, const int2048 &modulus) {
+  return int2048::Modulus(modulus).pow(base, exponent);
+}
+
+template <typename Iterator>
+int2048 product (Iterator first, Iterator last) {
+  std::vector<int2048> leaves;
+  std::uint64_t word = 1;
+  bool negative = false;
+  for (; first != last; ++first) {
+    const auto &factor = *first;
+    if constexpr (std::is_integral<std::decay_t<decltype(factor)>>::value) {
+      if (factor == 0) return 0;
+      negative ^= int2048::isNegative_(factor);
+      int2048::packFactor_(leaves, word, int2048::magnitude_(factor));
+    } else {
+      const int2048 &value = factor;
+      if (value.isNull_()) return 0;
+      negative ^= value.signbit_;
+      if (value.segments_.size() == 1) {
+        int2048::packFactor_(leaves, word, value.segments_[0]);
+      } else {
+        leaves.push_back(value);
+        leaves.back().signbit_ = false;
+      }
+    }
+  }
+  leaves.emplace_back();
+  leaves.back().setValue_(word, false);
+  int2048 res = int2048::productValue_(leaves);
+  res.signbit_ = negative;
+  return res;
+}
+
+inline int2048 factorial (unsigned n) {
+  std::vector<int2048> leaves;
+  std::uint64_t word = 1;
+  for (std::uint64_t i = 2; i <= n; ++i) int2048::packFactor_(leaves, word, i);
+  leaves.emplace_back();
+  leaves.back().setValue_(word, false);
+  return int2048::productValue_(leaves);
+}
+
+/* for n up to BINOMIAL_SIEVE_LIMIT and k not small beside n, the result is built from its factorization instead, with no
+   division: by Legendre's formula the prime p divides n choose k once for each i with
+   floor(n / p ** i) - floor(k / p ** i) - floor((n - k) / p ** i) equal to 1 (Kummer: once per carry when adding k and n - k in base p). */
+inline int2048 binomial (unsigned n, unsigned k) {
+  if (k > n) return 0;
+  if (k > n - k) k = n - k;
+  if (k == 0) return 1;
+  std::vector<int2048> leaves;
+  std::uint64_t word = 1;
+  const std::uint64_t log2n = 32 - __builtin_clz(n);
+  if (n > int2048::BINOMIAL_SIEVE_LIMIT || k * log2n * int2048::BINOMIAL_SIEVE_RATIO < n) {
+    for (std::uint64_t i = n - k + 1; i <= n; ++i) int2048::packFactor_(leaves, word, i);
+    leaves.emplace_back();
+    leaves.back().setValue_(word, false);
+    return divmod(int2048::productValue_(leaves), factorial(k)).quotient;
+  }
+  std::vector<bool> composite(n + 1);
+  for (std::uint64_t p = 2; p <= n; ++p) {
+    if (composite[p]) continue;
+    for (std::uint64_t multiple = p * p; multiple <= n; multiple += p) composite[multiple] = true;
+    for (std::uint64_t power = p; power <= n; power *= p) {
+      if (n / power - k / power - (n - k) / power != 0) int2048::packFactor_(leaves, word, p);
+    }
+  }
+  leaves.emplace_back();
+  leaves.back().setValue_(word, false);
+  return int2048::productValue_(leaves);
+}
 } // namespace sjtu
 
 #endif
@@ -0,0 +1,644 @@
+#ifndef SJTU_BIGINTEGER_BINARY_H
+#define SJTU_BIGINTEGER_BINARY_H
+
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <string>
+
+// Permitted by @Sakits
+#include <cstdint>
+
+#ifdef ONLINE_JUDGE
+// using `sizeof` here to suppress annoying warnings on unused variables, etc.
+#define assert(...) sizeof(__VA_ARGS__)
+#else
+#include <cassert>
+#endif
+
+namespace sjtu {
+/** Sibling of int2048 with the same interface, storing the magnitude in base 2 ** 64 limbs.
+    Arithmetic runs on plain carries and 64x64->128 products instead of reducing by a power of 10 per segment;
+    decimal text goes through divide-and-conquer radix conversion, which stays sub-quadratic. */
+class int2048b {
+ private:
+  using LimbType = std::uint64_t;
+  __extension__ using WideType = unsigned __int128;
+  static constexpr int LIMB_BITS = 64;
+  /// Largest power of 10 that fits in a limb, and its number of digits.
+  static constexpr LimbType CHUNK_MAX = 10000000000000000000ULL;
+  static constexpr int CHUNK_LENGTH = 19;
+  /// Multiplication crossover, in limbs of the shorter operand: schoolbook below, Karatsuba from here on.
+  static constexpr int KARATSUBA_THRESHOLD = 32;
+  /// Long division unless both the divisor and the quotient have at least this many limbs; Burnikel–Ziegler above.
+  static constexpr int BZ_DIV_THRESHOLD = 64;
+  /// Radix conversions of at most this many chunks run chunk by chunk instead of splitting.
+  static constexpr int RADIX_THRESHOLD = 32;
+  /// Little-endian limbs without leading zeroes; empty for 0.
+  std::vector<LimbType> limbs_;
+  bool signbit_ = false;
+
+  /// Strip leading zeroes. 0 is never negative.
+  void normalize_ () {
+    while (!limbs_.empty() && limbs_.back() == 0) limbs_.pop_back();
+    if (limbs_.empty()) signbit_ = false;
+  }
+  /// True if this is 0.
+  bool isNull_ () const {
+    return limbs_.empty();
+  }
+  /// Resets this to number, returns this.
+  int2048b &resetTo_ (LimbType number) {
+    signbit_ = false;
+    limbs_.clear();
+    if (number != 0) limbs_.push_back(number);
+    return *this;
+  }
+
+  /// Adds b (of size nb) to a (of size na >= nb) in place, returns the carry out of a.
+  static LimbType addLimbs_ (LimbType *a, int na, const LimbType *b, int nb) {
+    LimbType carry = 0;
+    int i = 0;
+    for (; i < nb; ++i) {
+      const WideType sum = static_cast<WideType>(a[i]) + b[i] + carry;
+      a[i] = static_cast<LimbType>(sum);
+      carry = static_cast<LimbType>(sum >> LIMB_BITS);
+    }
+    for (; carry && i < na; ++i) carry = ++a[i] == 0;
+    return carry;
+  }
+  /// Subtracts b (of size nb) from a (of size na >= nb) in place, returns the borrow out of a.
+  static LimbType subLimbs_ (LimbType *a, int na, const LimbType *b, int nb) {
+    LimbType borrow = 0;
+    int i = 0;
+    for (; i < nb; ++i) {
+      const LimbType difference = a[i] - b[i];
+      const LimbType nextBorrow = a[i] < b[i] || difference < borrow;
+      a[i] = difference - borrow;
+      borrow = nextBorrow;
+    }
+    for (; borrow && i < na; ++i) borrow = a[i]-- == 0;
+    return borrow;
+  }
+  /// Size of the limb range without leading zeroes.
+  static int trimmedSize_ (const LimbType *a, int n) {
+    while (n > 0 && a[n - 1] == 0) --n;
+    return n;
+  }
+  /// -1 if a < b, 0 if a = b, 1 if a > b, for trimmed limb ranges.
+  static int cmpLimbs_ (const LimbType *a, int na, const LimbType *b, int nb) {
+    if (na != nb) return na < nb ? -1 : 1;
+    for (int i = na - 1; i >= 0; --i) {
+      if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+  }
+
+  /// Multiplies a (of size na) by b (of size nb) into out (of size na + nb, zero-filled), schoolbook style.
+  static void mulSchoolbook_ (const LimbType *a, int na, const LimbType *b, int nb, LimbType *out) {
+    for (int i = 0; i < na; ++i) {
+      LimbType carry = 0;
+      for (int j = 0; j < nb; ++j) {
+        // (2 ** 64 - 1) ** 2 + 2 * (2 ** 64 - 1) = 2 ** 128 - 1, so this never overflows.
+        const WideType product = static_cast<WideType>(a[i]) * b[j] + out[i + j] + carry;
+        out[i + j] = static_cast<LimbType>(product);
+        carry = static_cast<LimbType>(product >> LIMB_BITS);
+      }
+      out[i + nb] = carry;
+    }
+  }
+  /// Same contract as mulSchoolbook_, Karatsuba style. Requires na >= nb.
+  static void mulKaratsuba_ (const LimbType *a, int na, const LimbType *b, int nb, LimbType *out) {
+    const int m = (na + 1) / 2;
+    if (nb <= m) {
+      // b has no upper half: out = a0 * b + a1 * b * 2 ** (64 * m).
+      mulLimbs_(a, m, b, nb, out);
+      std::vector<LimbType> upper(na - m + nb, 0);
+      mulLimbs_(a + m, na - m, b, nb, upper.data());
+      addLimbs_(out + m, na + nb - m, upper.data(), trimmedSize_(upper.data(), upper.size()));
+      return;
+    }
+    // (a0 + a1 x)(b0 + b1 x) = a0 b0 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) x + a1 b1 x ** 2.
+    mulLimbs_(a, m, b, m, out);
+    mulLimbs_(a + m, na - m, b + m, nb - m, out + 2 * m);
+    std::vector<LimbType> sumA(a, a + m + 1), sumB(b, b + m + 1);
+    sumA[m] = addLimbs_(sumA.data(), m, a + m, na - m);
+    sumB[m] = addLimbs_(sumB.data(), m, b + m, nb - m);
+    const int szSumA = trimmedSize_(sumA.data(), m + 1);
+    const int szSumB = trimmedSize_(sumB.data(), m + 1);
+    std::vector<LimbType> middle(szSumA + szSumB, 0);
+    mulLimbs_(sumA.data(), szSumA, sumB.data(), szSumB, middle.data());
+    subLimbs_(middle.data(), middle.size(), out, trimmedSize_(out, 2 * m));
+    subLimbs_(middle.data(), middle.size(), out + 2 * m, trimmedSize_(out + 2 * m, na + nb - 2 * m));
+    const LimbType carry = addLimbs_(out + m, na + nb - m, middle.data(), trimmedSize_(middle.data(), middle.size()));
+    assert(carry == 0);
+  }
+  /// Multiplies a (of size na) by b (of size nb) into out (of size na + nb, zero-filled), picking an algorithm by size.
+  static void mulLimbs_ (const LimbType *a, int na, const LimbType *b, int nb, LimbType *out) {
+    if (na < nb) {
+      std::swap(a, b);
+      std::swap(na, nb);
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+      mulSchoolbook_(a, na, b, nb, out);
+    } else if (na >= 2 * nb) {
+      // unbalanced: multiply b by nb-sized slices of a.
+      std::vector<LimbType> slice(2 * nb);
+      for (int offset = 0; offset < na; offset += nb) {
+        const int szSlice = na - offset < nb ? na - offset : nb;
+        std::fill(slice.begin(), slice.end(), 0);
+        mulLimbs_(a + offset, szSlice, b, nb, slice.data());
+        addLimbs_(out + offset, na + nb - offset, slice.data(), trimmedSize_(slice.data(), szSlice + nb));
+      }
+    } else {
+      mulKaratsuba_(a, na, b, nb, out);
+    }
+  }
+
+  /// Multiplies the absolute value of this by factor and adds addend, in place.
+  int2048b &mulSmallAdd_ (LimbType factor, LimbType addend) {
+    LimbType carry = addend;
+    for (auto &limb : limbs_) {
+      const WideType product = static_cast<WideType>(limb) * factor + carry;
+      limb = static_cast<LimbType>(product);
+      carry = static_cast<LimbType>(product >> LIMB_BITS);
+    }
+    if (carry != 0) limbs_.push_back(carry);
+    return *this;
+  }
+  /// Divides the absolute value of this by divisor in place, returns the remainder.
+  LimbType divSmall_ (LimbType divisor) {
+    LimbType remainder = 0;
+    for (int i = limbs_.size() - 1; i >= 0; --i) {
+      const WideType current = static_cast<WideType>(remainder) << LIMB_BITS | limbs_[i];
+      limbs_[i] = static_cast<LimbType>(current / divisor);
+      remainder = static_cast<LimbType>(current % divisor);
+    }
+    normalize_();
+    return remainder;
+  }
+  /// Multiplies the absolute value of this by 2 ** (64 * count), or drops the lowest -count limbs if count is negative.
+  int2048b &shiftLimbs_ (int count) {
+    if (isNull_() || count == 0) return *this;
+    if (count > 0) {
+      limbs_.insert(limbs_.begin(), count, 0);
+    } else {
+      limbs_.erase(limbs_.begin(), limbs_.begin() + std::min<std::size_t>(-count, limbs_.size()));
+      normalize_();
+    }
+    return *this;
+  }
+  /// Multiplies the absolute value of this by 2 ** count, or floor divides by 2 ** -count if count is negative; |count| < 64.
+  int2048b &shiftBits_ (int count) {
+    if (isNull_() || count == 0) return *this;
+    const int size = limbs_.size();
+    if (count > 0) {
+      limbs_.push_back(0);
+      for (int i = size; i > 0; --i) limbs_[i] = limbs_[i] << count | limbs_[i - 1] >> (LIMB_BITS - count);
+      limbs_[0] <<= count;
+    } else {
+      count = -count;
+      for (int i = 0; i + 1 < size; ++i) limbs_[i] = limbs_[i] >> count | limbs_[i + 1] << (LIMB_BITS - count);
+      limbs_[size - 1] >>= count;
+    }
+    normalize_();
+    return *this;
+  }
+
+  /// Adds values of this and that in place, disregarding sign bit.
+  int2048b &addValue_ (const int2048b &that) {
+    const int szThat = that.limbs_.size();
+    if (static_cast<int>(limbs_.size()) < szThat) limbs_.resize(szThat, 0);
+    const LimbType carry = addLimbs_(limbs_.data(), limbs_.size(), that.limbs_.data(), szThat);
+    if (carry != 0) limbs_.push_back(carry);
+    return *this;
+  }
+  /// Subtracts that from this in place, disregarding sign bit; flips the sign if abs(that) > abs(this).
+  int2048b &subValue_ (const int2048b &that) {
+    const int szThis = limbs_.size();
+    const int szThat = that.limbs_.size();
+    if (cmpLimbs_(limbs_.data(), szThis, that.limbs_.data(), szThat) >= 0) {
+      subLimbs_(limbs_.data(), szThis, that.limbs_.data(), szThat);
+    } else {
+      // abs(a - b) = b - a.
+      std::vector<LimbType> difference(that.limbs_);
+      subLimbs_(difference.data(), szThat, limbs_.data(), szThis);
+      limbs_.swap(difference);
+      signbit_ = !signbit_;
+    }
+    normalize_();
+    return *this;
+  }
+
+ public:
+  int2048b () = default;
+  int2048b (long long number) : signbit_(number < 0) {
+    // do not use `-number` here, because negating LLONG_MIN is undefined behavior.
+    const unsigned long long magnitude = number > 0 ? number : 0ULL - number;
+    if (magnitude != 0) limbs_.push_back(magnitude);
+  }
+  int2048b (const std::string &string) {
+    read(string);
+  }
+  int2048b (const int2048b &that) = default;
+  /// Leaves that as 0.
+  int2048b (int2048b &&that) noexcept : limbs_(std::move(that.limbs_)), signbit_(that.signbit_) {
+    that.resetTo_(0);
+  }
+
+  void read (const std::string &string) {
+    resetTo_(0);
+    const bool negative = !string.empty() && string[0] == '-';
+    const int begin = negative ? 1 : 0;
+    const int length = string.length() - begin;
+    if (length <= 0) return;
+    // little-endian chunks of CHUNK_LENGTH digits each.
+    const int szChunks = (length + CHUNK_LENGTH - 1) / CHUNK_LENGTH;
+    std::vector<LimbType> chunks(szChunks, 0);
+    for (int i = 0; i < szChunks; ++i) {
+      const int end = string.length() - i * CHUNK_LENGTH;
+      const int start = end - CHUNK_LENGTH > begin ? end - CHUNK_LENGTH : begin;
+      for (int j = start; j < end; ++j) chunks[i] = chunks[i] * 10 + (string[j] - '0');
+    }
+    *this = fromChunks_(chunks.data(), szChunks);
+    // this is not IEEE 754. There are no negative zeroes.
+    signbit_ = negative && !isNull_();
+  }
+  void print () const {
+    std::cout << *this;
+  }
+
+  int2048b &add (const int2048b &that) {
+    return signbit_ == that.signbit_ ? addValue_(that) : subValue_(that);
+  }
+  friend int2048b add (const int2048b &a, const int2048b &b) {
+    return a + b;
+  }
+
+  int2048b &minus (const int2048b &that) {
+    return signbit_ != that.signbit_ ? addValue_(that) : subValue_(that);
+  }
+  friend int2048b minus (const int2048b &minuend, const int2048b &subtrahend) {
+    return minuend - subtrahend;
+  }
+
+  int2048b &operator= (const int2048b &that) = default;
+  int2048b &operator= (int2048b &&that) noexcept {
+    // swapping hands our old buffer to that, so it stays a valid number.
+    swap(that);
+    return *this;
+  }
+  void swap (int2048b &that) noexcept {
+    limbs_.swap(that.limbs_);
+    std::swap(signbit_, that.signbit_);
+  }
+  friend void swap (int2048b &a, int2048b &b) noexcept {
+    a.swap(b);
+  }
+
+  int2048b &operator+= (const int2048b &that) {
+    return add(that);
+  }
+  // the rvalue overloads reuse the buffer of a temporary operand.
+  friend int2048b operator+ (const int2048b &a, const int2048b &b) {
+    int2048b res(a);
+    res.add(b);
+    return res;
+  }
+  friend int2048b operator+ (int2048b &&a, const int2048b &b) {
+    a.add(b);
+    return std::move(a);
+  }
+  friend int2048b operator+ (const int2048b &a, int2048b &&b) {
+    b.add(a);
+    return std::move(b);
+  }
+  friend int2048b operator+ (int2048b &&a, int2048b &&b) {
+    a.add(b);
+    return std::move(a);
+  }
+
+  int2048b &operator-= (const int2048b &that) {
+    return minus(that);
+  }
+  friend int2048b operator- (const int2048b &minuend, const int2048b &subtrahend) {
+    int2048b res(minuend);
+    res.minus(subtrahend);
+    return res;
+  }
+  friend int2048b operator- (int2048b &&minuend, const int2048b &subtrahend) {
+    minuend.minus(subtrahend);
+    return std::move(minuend);
+  }
+  friend int2048b operator- (const int2048b &minuend, int2048b &&subtrahend) {
+    // a - b = -(b - a).
+    subtrahend.minus(minuend);
+    if (!subtrahend.isNull_()) subtrahend.signbit_ = !subtrahend.signbit_;
+    return std::move(subtrahend);
+  }
+  friend int2048b operator- (int2048b &&minuend, int2048b &&subtrahend) {
+    minuend.minus(subtrahend);
+    return std::move(minuend);
+  }
+
+  int2048b &operator*= (const int2048b &that) {
+    if (isNull_()) return *this;
+    if (that.isNull_()) return resetTo_(0);
+    if (that.signbit_) signbit_ = !signbit_;
+    const int szThis = limbs_.size();
+    const int szThat = that.limbs_.size();
+    std::vector<LimbType> result(szThis + szThat, 0);
+    mulLimbs_(limbs_.data(), szThis, that.limbs_.data(), szThat, result.data());
+    limbs_.swap(result);
+    normalize_();
+    return *this;
+  }
+  friend int2048b operator* (int2048b a, const int2048b &b) {
+    a *= b;
+    return a;
+  }
+
+ private:
+  template <typename T>
+  struct DivisionResult_ {
+    T quotient;
+    T remainder;
+  };
+  /// Splits the absolute value at 2 ** (64 * cntLimbs) into quotient and remainder.
+  DivisionResult_<int2048b> rshift_ (int cntLimbs) const {
+    DivisionResult_<int2048b> res;
+    const int szThis = limbs_.size();
+    const int cnt = cntLimbs < szThis ? cntLimbs : szThis;
+    res.remainder.limbs_.assign(limbs_.begin(), limbs_.begin() + cnt);
+    res.quotient.limbs_.assign(limbs_.begin() + cnt, limbs_.end());
+    res.remainder.normalize_();
+    return res;
+  }
+  /** Divides u (of size nu, followed by one more zero limb) by v (of size nv >= 2, top bit set).
+      Writes the nu - nv + 1 quotient limbs into q and leaves the remainder in the lowest nv limbs of u. */
+  static void divKnuth_ (LimbType *u, int nu, const LimbType *v, int nv, LimbType *q) {
+    // Knuth, The Art of Computer Programming, volume 2, section 4.3.1, Algorithm D.
+    const LimbType vTop = v[nv - 1];
+    const LimbType vNext = v[nv - 2];
+    for (int j = nu - nv; j >= 0; --j) {
+      const WideType numerator = static_cast<WideType>(u[j + nv]) << LIMB_BITS | u[j + nv - 1];
+      WideType qHat = numerator / vTop;
+      WideType rHat = numerator % vTop;
+      while (qHat >> LIMB_BITS || qHat * vNext > (rHat << LIMB_BITS | u[j + nv - 2])) {
+        --qHat;
+        rHat += vTop;
+        if (rHat >> LIMB_BITS) break;
+      }
+      // u[j .. j + nv] -= qHat * v.
+      LimbType carry = 0, borrow = 0;
+      for (int i = 0; i < nv; ++i) {
+        const WideType product = qHat * v[i] + carry;
+        const LimbType low = static_cast<LimbType>(product);
+        carry = static_cast<LimbType>(product >> LIMB_BITS);
+        const LimbType difference = u[i + j] - low;
+        const LimbType nextBorrow = u[i + j] < low || difference < borrow;
+        u[i + j] = difference - borrow;
+        borrow = nextBorrow;
+      }
+      const LimbType top = u[j + nv];
+      u[j + nv] = top - carry - borrow;
+      if (top < carry || top - carry < borrow) {
+        // qHat was one too large, which happens with probability about 2 / 2 ** 64; the add-back wraps the top limb to 0.
+        --qHat;
+        u[j + nv] += addLimbs_(u + j, nv, v, nv);
+      }
+      q[j] = static_cast<LimbType>(qHat);
+    }
+  }
+  /// Long division returning the remainder as well, for numerator and denominator non-negative.
+  static DivisionResult_<int2048b> divModSchoolbook_ (const int2048b &numerator, const int2048b &denominator) {
+    DivisionResult_<int2048b> res;
+    if (cmpValue_(numerator, denominator) < 0) {
+      res.remainder = numerator;
+      return res;
+    }
+    const int szDenominator = denominator.limbs_.size();
+    if (szDenominator == 1) {
+      res.quotient = numerator;
+      res.remainder.resetTo_(res.quotient.divSmall_(denominator.limbs_[0]));
+      return res;
+    }
+    // normalize so that the top bit of the denominator is set.
+    const int shift = __builtin_clzll(denominator.limbs_.back());
+    int2048b u = numerator, v = denominator;
+    u.shiftBits_(shift);
+    v.shiftBits_(shift);
+    const int szU = u.limbs_.size();
+    u.limbs_.push_back(0);
+    res.quotient.limbs_.assign(szU - szDenominator + 1, 0);
+    divKnuth_(u.limbs_.data(), szU, v.limbs_.data(), szDenominator, res.quotient.limbs_.data());
+    res.quotient.normalize_();
+    u.limbs_.resize(szDenominator);
+    u.normalize_();
+    u.shiftBits_(-shift);
+    res.remainder = std::move(u);
+    return res;
+  }
+  /// Burnikel–Ziegler 2n/1n step. Requires numerator < denominator * 2 ** (64 * n), and denominator normalized with n limbs.
+  static DivisionResult_<int2048b> div2n1n_ (const int2048b &numerator, const int2048b &denominator, int n) {
+    // Burnikel and Ziegler, Fast Recursive Division (MPI-I-98-1-022), Algorithm 1.
+    if (n % 2 == 1 || n < BZ_DIV_THRESHOLD) return divModSchoolbook_(numerator, denominator);
+    const int half = n / 2;
+    auto lowest = numerator.rshift_(half);
+    auto upper = div3n2n_(lowest.quotient, denominator, half);
+    int2048b &next = upper.remainder;
+    next.shiftLimbs_(half);
+    next.addValue_(lowest.remainder);
+    auto lower = div3n2n_(next, denominator, half);
+    upper.quotient.shiftLimbs_(half);
+    upper.quotient.addValue_(lower.quotient);
+    return { upper.quotient, lower.remainder };
+  }
+  /// Burnikel–Ziegler 3n/2n step on half-limb blocks. Requires numerator < denominator * 2 ** (64 * half), and denominator normalized with 2 * half limbs.
+  static DivisionResult_<int2048b> div3n2n_ (const int2048b &numerator, const int2048b &denominator, int half) {
+    // Burnikel and Ziegler, Fast Recursive Division (MPI-I-98-1-022), Algorithm 2.
+    const auto splitNumerator = numerator.rshift_(half);
+    const auto splitDenominator = denominator.rshift_(half);
+    const int2048b &upperDenominator = splitDenominator.quotient;
+    DivisionResult_<int2048b> res;
+    if (cmpValue_(splitNumerator.quotient.rshift_(half).quotient, upperDenominator) < 0) {
+      res = div2n1n_(splitNumerator.quotient, upperDenominator, half);
+    } else {
+      // the quotient estimate saturates at 2 ** (64 * half) - 1.
+      res.quotient.limbs_.assign(half, ~static_cast<LimbType>(0));
+      res.remainder = splitNumerator.quotient;
+      int2048b shifted = upperDenominator;
+      shifted.shiftLimbs_(half);
+      res.remainder.subValue_(shifted);
+      res.remainder.addValue_(upperDenominator);
+    }
+    int2048b product = res.quotient;
+    product *= splitDenominator.remainder;
+    res.remainder.shiftLimbs_(half);
+    res.remainder.addValue_(splitNumerator.remainder);
+    res.remainder.minus(product);
+    // at most two corrections are needed.
+    while (res.remainder.signbit_) {
+      res.quotient.subValue_(1);
+      res.remainder.add(denominator);
+    }
+    return res;
+  }
+  /// Divides numerator by denominator with Burnikel–Ziegler recursion, both non-negative and denominator not null.
+  static DivisionResult_<int2048b> divBurnikelZiegler_ (const int2048b &numerator, const int2048b &denominator) {
+    // Burnikel and Ziegler, Fast Recursive Division (MPI-I-98-1-022), Section 4.
+    const int szDenominator = denominator.limbs_.size();
+    // the block size n = j * 2 ** k stays even while halving down to fewer than BZ_DIV_THRESHOLD limbs.
+    int m = 1;
+    while (m * BZ_DIV_THRESHOLD <= szDenominator) m <<= 1;
+    const int n = (szDenominator + m - 1) / m * m;
+    const int shift = __builtin_clzll(denominator.limbs_.back());
+    int2048b a = numerator, b = denominator;
+    a.shiftBits_(shift);
+    b.shiftBits_(shift);
+    a.shiftLimbs_(n - szDenominator);
+    b.shiftLimbs_(n - szDenominator);
+    // a has at most t * n - 1 limbs, so its leading block is less than b.
+    const int szA = a.limbs_.size();
+    const int t = (szA + n) / n > 2 ? (szA + n) / n : 2;
+    auto split = a.rshift_((t - 2) * n);
+    int2048b block = split.quotient;
+    int2048b rest = split.remainder;
+    DivisionResult_<int2048b> res;
+    for (int i = t - 2; i >= 0; --i) {
+      auto step = div2n1n_(block, b, n);
+      res.quotient.shiftLimbs_(n);
+      res.quotient.addValue_(step.quotient);
+      if (i == 0) {
+        res.remainder = std::move(step.remainder);
+        break;
+      }
+      auto nextSplit = rest.rshift_((i - 1) * n);
+      block = std::move(step.remainder);
+      block.shiftLimbs_(n);
+      block.addValue_(nextSplit.quotient);
+      rest = std::move(nextSplit.remainder);
+    }
+    res.remainder.shiftLimbs_(szDenominator - n);
+    res.remainder.shiftBits_(-shift);
+    return res;
+  }
+  /// Divides numerator by denominator, both non-negative and denominator not null, picking an algorithm by size.
+  static DivisionResult_<int2048b> divMod_ (const int2048b &numerator, const int2048b &denominator) {
+    const int szNumerator = numerator.limbs_.size();
+    const int szDenominator = denominator.limbs_.size();
+    if (szDenominator < BZ_DIV_THRESHOLD || szNumerator - szDenominator < BZ_DIV_THRESHOLD) return divModSchoolbook_(numerator, denominator);
+    return divBurnikelZiegler_(numerator, denominator);
+  }
+
+  /* radix conversion splits the value at CHUNK_MAX ** (2 ** k), so both halves recurse on balanced sizes.
+     See: Brent and Zimmermann, Modern Computer Arithmetic, section 1.7. */
+  /// CHUNK_MAX ** (2 ** k), cached per thread.
+  static const int2048b &chunkPower_ (int k) {
+    static thread_local std::vector<int2048b> powers;
+    if (powers.empty()) {
+      powers.emplace_back();
+      powers[0].resetTo_(CHUNK_MAX);
+    }
+    while (static_cast<int>(powers.size()) <= k) powers.push_back(powers.back() * powers.back());
+    return powers[k];
+  }
+  /// Largest k with 2 ** k < n, for n >= 2.
+  static int splitLevel_ (int n) {
+    int k = 0;
+    while ((2 << k) < n) ++k;
+    return k;
+  }
+  /// Builds a non-negative value from n little-endian base CHUNK_MAX chunks.
+  static int2048b fromChunks_ (const LimbType *chunks, int n) {
+    int2048b res;
+    if (n <= RADIX_THRESHOLD) {
+      for (int i = n - 1; i >= 0; --i) res.mulSmallAdd_(CHUNK_MAX, chunks[i]);
+      res.normalize_();
+      return res;
+    }
+    const int k = splitLevel_(n);
+    const int szLow = 1 << k;
+    res = fromChunks_(chunks + szLow, n - szLow);
+    res *= chunkPower_(k);
+    res.addValue_(fromChunks_(chunks, szLow));
+    return res;
+  }
+  /// Writes the absolute value of value (less than CHUNK_MAX ** n) as n little-endian base CHUNK_MAX chunks.
+  static void toChunks_ (int2048b value, LimbType *chunks, int n) {
+    if (n <= RADIX_THRESHOLD) {
+      for (int i = 0; i < n; ++i) chunks[i] = value.divSmall_(CHUNK_MAX);
+      return;
+    }
+    const int k = splitLevel_(n);
+    const int szLow = 1 << k;
+    auto split = divMod_(value, chunkPower_(k));
+    toChunks_(std::move(split.remainder), chunks, szLow);
+    toChunks_(std::move(split.quotient), chunks + szLow, n - szLow);
+  }
+
+ public:
+  int2048b &operator/= (const int2048b &that) {
+    assert(!that.isNull_());
+    if (isNull_()) return *this;
+    assert(!signbit_ && !that.signbit_);
+    return *this = std::move(divMod_(*this, that).quotient);
+  }
+  friend int2048b operator/ (int2048b a, const int2048b &b) {
+    a /= b;
+    return a;
+  }
+
+  friend std::istream &operator>> (std::istream &stream, int2048b &number) {
+    std::string str;
+    stream >> str;
+    number.read(str);
+    return stream;
+  }
+  friend std::ostream &operator<< (std::ostream &stream, const int2048b &number) {
+    if (number.isNull_()) return stream << '0';
+    if (number.signbit_) stream << '-';
+    // 2 ** 64 < CHUNK_MAX ** (1 + 1 / 32), so this many chunks always suffice.
+    const int szLimbs = number.limbs_.size();
+    const int szChunks = szLimbs + szLimbs / 32 + 1;
+    std::vector<LimbType> chunks(szChunks);
+    toChunks_(number, chunks.data(), szChunks);
+    const int top = trimmedSize_(chunks.data(), szChunks) - 1;
+    std::string str = std::to_string(chunks[top]);
+    str.reserve(str.size() + top * CHUNK_LENGTH);
+    char buffer[CHUNK_LENGTH];
+    for (int i = top - 1; i >= 0; --i) {
+      LimbType current = chunks[i];
+      for (int j = CHUNK_LENGTH - 1; j >= 0; --j) {
+        buffer[j] = (current % 10) + '0';
+        current /= 10;
+      }
+      str.append(buffer, CHUNK_LENGTH);
+    }
+    return stream << str;
+  }
+
+ private:
+  /// -1 if lhs < rhs, 0 if lhs = rhs, 1 if lhs > rhs; ignores sign bit.
+  static int cmpValue_ (const int2048b &lhs, const int2048b &rhs) {
+    return cmpLimbs_(lhs.limbs_.data(), lhs.limbs_.size(), rhs.limbs_.data(), rhs.limbs_.size());
+  }
+  /// -1 if lhs < rhs, 0 if lhs = rhs, 1 if lhs > rhs
+  static int cmp_ (const int2048b &lhs, const int2048b &rhs) {
+    if (lhs.signbit_ != rhs.signbit_) return lhs.signbit_ ? -1 : 1;
+    return lhs.signbit_ ? -cmpValue_(lhs, rhs) : cmpValue_(lhs, rhs);
+  }
+
+ public:
+  inline friend bool operator== (const int2048b &lhs, const int2048b &rhs) { return cmp_(lhs, rhs) == 0; }
+  inline friend bool operator!= (const int2048b &lhs, const int2048b &rhs) { return cmp_(lhs, rhs) != 0; }
+  inline friend bool operator<  (const int2048b &lhs, const int2048b &rhs) { return cmp_(lhs, rhs) <  0; }
+  inline friend bool operator>  (const int2048b &lhs, const int2048b &rhs) { return cmp_(lhs, rhs) >  0; }
+  inline friend bool operator<= (const int2048b &lhs, const int2048b &rhs) { return cmp_(lhs, rhs) <= 0; }
+  inline friend bool operator>= (const int2048b &lhs, const int2048b &rhs) { return cmp_(lhs, rhs) >= 0; }
+};
+} // namespace sjtu
+
+#endif